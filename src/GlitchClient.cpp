@@ -0,0 +1,844 @@
+#include "GlitchSDK.h"
+#include <algorithm>
+#include <chrono>
+#include <cerrno>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <iterator>
+
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+namespace GlitchSDK
+{
+    // --- Telemetry client ---
+
+    namespace
+    {
+        struct QueuedEvent
+        {
+            GameEventData Event;
+            int Attempts = 0;       // Failed sends so far that count towards MaxEventAttempts
+            uint64_t Seq = 0;       // Queue order; the crash ring is indexed by it
+        };
+
+        typedef std::deque<QueuedEvent, Internal::TaggedAllocator<QueuedEvent, MemoryTag::Queues> > EventQueue;
+        typedef std::deque<PurchaseData, Internal::TaggedAllocator<PurchaseData, MemoryTag::Queues> > PurchaseQueue;
+
+        // Throttling, 503 and no response at all say nothing about the event itself, so
+        // they leave it queued without using up one of its MaxEventAttempts
+        bool UsesAttempt(long status)
+        {
+            return status != 0 && status != 429 && status != 503;
+        }
+
+        // Longest server Retry-After the drain waits out; a larger one is treated as this
+        const std::chrono::seconds MaxRetryAfter(300);
+
+        void DeadLetter(const ClientConfig& config, const QueuedEvent& queued, long status, const std::string& error)
+        {
+            Internal::Counters().EventsDeadLettered.fetch_add(1, std::memory_order_relaxed);
+            if (config.DeadLetterPath.empty()) return;
+            Internal::JsonString item;
+            Internal::AppendEventJSON(item, queued.Event);
+            Internal::AppendDeadLetter(config.DeadLetterPath, "event", status, error, queued.Attempts, item);
+        }
+
+        void DeadLetter(const ClientConfig& config, const PurchaseData& purchase, long status,
+                        const std::string& response, int attempts)
+        {
+            Internal::Counters().PurchasesDeadLettered.fetch_add(1, std::memory_order_relaxed);
+            if (config.DeadLetterPath.empty()) return;
+            std::string error;
+            Internal::ExtractJSONString(response, "error", error);
+            if (error.empty() && Internal::IsRetryableStatus(status)) error = "retries_exhausted";
+            std::string json = PurchaseToJSON(purchase);
+            Internal::AppendDeadLetter(config.DeadLetterPath, "purchase", status, error, attempts,
+                                       Internal::JsonString(json.data(), json.size()));
+        }
+
+        // Spool file: one record per line, with length-prefixed fields so any bytes round-trip.
+        //   E <attempts> <len>:<install> <len>:<step> <len>:<action> <len>:<metadata> <len>:<timestamp> \n
+        //   P <attempts> <len>:<install> <len>:<type> <len>:<amount> <len>:<currency> <len>:<transaction>
+        //                <len>:<sku> <len>:<name> <len>:<quantity> <len>:<metadata> \n
+        // A record cut short by a crash fails to parse and is skipped.
+
+        // Writes into a fixed buffer without allocating; Size keeps counting past Capacity
+        // so a first pass with no buffer measures a record
+        struct SpoolBuffer
+        {
+            SpoolBuffer(char* out, size_t capacity) : Out(out), Capacity(capacity) {}
+
+            void Append(const char* data, size_t size)
+            {
+                if (Out && Size + size <= Capacity) memcpy(Out + Size, data, size);
+                Size += size;
+            }
+
+            void Number(uint64_t value)
+            {
+                char digits[20];
+                size_t count = 0;
+                do {
+                    digits[sizeof(digits) - ++count] = char('0' + value % 10);
+                    value /= 10;
+                } while (value > 0);
+                Append(digits + sizeof(digits) - count, count);
+            }
+
+            void Field(const char* data, size_t size)
+            {
+                Number(size);
+                Append(":", 1);
+                Append(data, size);
+                Append(" ", 1);
+            }
+
+            void Field(const std::string& field) { Field(field.data(), field.size()); }
+
+            char* Out;
+            size_t Capacity;
+            size_t Size = 0;
+        };
+
+        void FormatSpoolRecord(SpoolBuffer& out, const QueuedEvent& queued)
+        {
+            out.Append("E ", 2);
+            out.Number(uint64_t(std::max(queued.Attempts, 0)));
+            out.Append(" ", 1);
+            out.Field(queued.Event.GameInstallID);
+            out.Field(queued.Event.StepKey);
+            out.Field(queued.Event.ActionKey);
+            out.Field(queued.Event.MetadataJSON);
+            out.Field(queued.Event.EventTimestamp);
+            out.Append("\n", 1);
+        }
+
+        void FormatSpoolRecord(SpoolBuffer& out, const PurchaseData& purchase)
+        {
+            char amount[32];
+            int amountSize = snprintf(amount, sizeof(amount), "%.9g", double(purchase.PurchaseAmount));
+            std::string quantity = std::to_string(purchase.Quantity);
+            out.Append("P 0 ", 4);
+            out.Field(purchase.GameInstallID);
+            out.Field(purchase.PurchaseType);
+            out.Field(amount, size_t(std::max(amountSize, 0)));
+            out.Field(purchase.Currency);
+            out.Field(purchase.TransactionID);
+            out.Field(purchase.ItemSKU);
+            out.Field(purchase.ItemName);
+            out.Field(quantity);
+            out.Field(purchase.MetadataJSON);
+            out.Append("\n", 1);
+        }
+
+        template <class T>
+        void AppendSpoolRecord(std::string& records, const T& item)
+        {
+            SpoolBuffer measure(nullptr, 0);
+            FormatSpoolRecord(measure, item);
+            size_t at = records.size();
+            records.resize(at + measure.Size);
+            SpoolBuffer out(&records[at], measure.Size);
+            FormatSpoolRecord(out, item);
+        }
+
+        bool ParseSpoolNumber(const char*& p, const char* end, char terminator, size_t& value)
+        {
+            const char* start = p;
+            value = 0;
+            while (p < end && *p >= '0' && *p <= '9' && p - start < 12) value = value * 10 + size_t(*p++ - '0');
+            if (p == start || p == end || *p != terminator) return false;
+            p++;
+            return true;
+        }
+
+        // One record starting at p; leaves p after it on success
+        bool ParseSpoolRecord(const char*& p, const char* end, char& kind, int& attempts, std::vector<std::string>& fields)
+        {
+            fields.clear();
+            if (end - p < 2 || (*p != 'E' && *p != 'P') || p[1] != ' ') return false;
+            kind = *p;
+            p += 2;
+            size_t number = 0;
+            if (!ParseSpoolNumber(p, end, ' ', number)) return false;
+            attempts = int(number);
+            while (p < end && *p != '\n') {
+                if (!ParseSpoolNumber(p, end, ':', number) || size_t(end - p) < number + 1 || p[number] != ' ') return false;
+                fields.push_back(std::string(p, number));
+                p += number + 1;
+            }
+            if (p == end) return false;
+            p++;
+            return fields.size() == (kind == 'E' ? 5u : 9u);
+        }
+
+        // Queue every intact record in the spool, then remove it
+        size_t ReplaySpool(const std::string& path, EventQueue& events, PurchaseQueue& purchases)
+        {
+            std::FILE* file = std::fopen(path.c_str(), "rb");
+            if (!file) return 0;
+            std::string data;
+            char buffer[64 * 1024];
+            size_t length;
+            while ((length = std::fread(buffer, 1, sizeof(buffer), file)) > 0) data.append(buffer, length);
+            std::fclose(file);
+            std::remove(path.c_str());
+
+            size_t replayed = 0;
+            std::vector<std::string> fields;
+            const char* p = data.data();
+            const char* end = p + data.size();
+            while (p < end) {
+                const char* start = p;
+                char kind = 0;
+                int attempts = 0;
+                if (!ParseSpoolRecord(p, end, kind, attempts, fields)) {
+                    const char* newline = (const char*)memchr(start, '\n', size_t(end - start));
+                    p = newline ? newline + 1 : end;
+                    continue;
+                }
+                if (kind == 'E') {
+                    QueuedEvent queued;
+                    queued.Attempts = attempts;
+                    queued.Event.GameInstallID = std::move(fields[0]);
+                    queued.Event.StepKey = std::move(fields[1]);
+                    queued.Event.ActionKey = std::move(fields[2]);
+                    queued.Event.MetadataJSON = std::move(fields[3]);
+                    queued.Event.EventTimestamp = std::move(fields[4]);
+                    events.push_back(std::move(queued));
+                } else {
+                    PurchaseData purchase(fields[0]);
+                    purchase.PurchaseType = std::move(fields[1]);
+                    purchase.PurchaseAmount = std::strtof(fields[2].c_str(), nullptr);
+                    purchase.Currency = std::move(fields[3]);
+                    purchase.TransactionID = std::move(fields[4]);
+                    purchase.ItemSKU = std::move(fields[5]);
+                    purchase.ItemName = std::move(fields[6]);
+                    purchase.Quantity = std::atoi(fields[7].c_str());
+                    purchase.MetadataJSON = std::move(fields[8]);
+                    purchases.push_back(std::move(purchase));
+                }
+                replayed++;
+            }
+            return replayed;
+        }
+
+        bool AppendSpool(const std::string& path, const std::string& records)
+        {
+            static std::mutex mutex;
+            std::lock_guard<std::mutex> lock(mutex);
+            std::FILE* file = std::fopen(path.c_str(), "ab");
+            if (!file) return false;
+            bool written = std::fwrite(records.data(), 1, records.size(), file) == records.size();
+            return std::fclose(file) == 0 && written;
+        }
+    }
+
+    // --- Crash flush ---
+
+    namespace
+    {
+        const size_t kCrashRecordBytes = 1024; // Larger events are left out of the crash ring
+
+        struct CrashSlot
+        {
+            std::atomic<uint64_t> Tag;  // Seq + 1 of the record held; 0 while empty or being rewritten
+            uint32_t Size;
+            char Data[kCrashRecordBytes];
+        };
+
+        /**
+         * Newest unsent events, already formatted as spool records, in preallocated
+         * slots. Written under Client::State::Mutex; Flush() reads it without locks
+         * (slot tags work as a seqlock) and only calls write(), so it is safe in a
+         * signal handler.
+         */
+        class CrashRing
+        {
+        public:
+            explicit CrashRing(size_t count) : Slots(new CrashSlot[count]), Count(count), NextSeq(0), PendingFrom(0)
+            {
+                for (size_t i = 0; i < Count; ++i) Slots[i].Tag.store(0, std::memory_order_relaxed);
+            }
+
+            ~CrashRing()
+            {
+#ifdef _WIN32
+                if (File != INVALID_HANDLE_VALUE) CloseHandle(File);
+#else
+                if (File >= 0) close(File);
+#endif
+            }
+
+            CrashRing(const CrashRing&) = delete;
+            CrashRing& operator=(const CrashRing&) = delete;
+
+            // Opened up front so the crash path never has to
+            bool Open(const std::string& path)
+            {
+#ifdef _WIN32
+                File = CreateFileA(path.c_str(), FILE_APPEND_DATA, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                                   NULL, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+                return File != INVALID_HANDLE_VALUE;
+#else
+                File = open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+                return File >= 0;
+#endif
+            }
+
+            void Remember(const QueuedEvent& queued)
+            {
+                CrashSlot& slot = Slots[queued.Seq % Count];
+                slot.Tag.store(0, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_release);
+                SpoolBuffer out(slot.Data, sizeof(slot.Data));
+                FormatSpoolRecord(out, queued);
+                slot.Size = uint32_t(out.Size);
+                if (out.Size <= sizeof(slot.Data)) slot.Tag.store(queued.Seq + 1, std::memory_order_release);
+                if (queued.Seq + 1 > NextSeq.load(std::memory_order_relaxed)) NextSeq.store(queued.Seq + 1, std::memory_order_release);
+            }
+
+            // Events before seq have been accepted, dead-lettered or spooled
+            void SetPendingFrom(uint64_t seq) { PendingFrom.store(seq, std::memory_order_release); }
+
+            // Async-signal-safe
+            void Flush()
+            {
+                uint64_t end = NextSeq.load(std::memory_order_acquire);
+                uint64_t seq = PendingFrom.load(std::memory_order_acquire);
+                if (end > Count && seq < end - Count) seq = end - Count;
+                char record[kCrashRecordBytes];
+                for (; seq < end; ++seq) {
+                    CrashSlot& slot = Slots[seq % Count];
+                    uint64_t tag = slot.Tag.load(std::memory_order_acquire);
+                    size_t size = slot.Size;
+                    if (tag != seq + 1 || size > sizeof(record)) continue;
+                    memcpy(record, slot.Data, size);
+                    std::atomic_thread_fence(std::memory_order_acquire);
+                    if (slot.Tag.load(std::memory_order_relaxed) != tag) continue; // Rewritten while copying
+                    Write(record, size);
+                }
+                PendingFrom.store(end, std::memory_order_release); // A second flush adds nothing
+            }
+
+        private:
+            void Write(const char* data, size_t size)
+            {
+                while (size > 0) {
+#ifdef _WIN32
+                    DWORD written = 0;
+                    if (!WriteFile(File, data, DWORD(size), &written, NULL) || written == 0) return;
+#else
+                    ssize_t written = write(File, data, size);
+                    if (written < 0 && errno == EINTR) continue;
+                    if (written <= 0) return;
+#endif
+                    data += written;
+                    size -= size_t(written);
+                }
+            }
+
+            std::unique_ptr<CrashSlot[]> Slots;
+            const size_t Count;
+            std::atomic<uint64_t> NextSeq;
+            std::atomic<uint64_t> PendingFrom;
+#ifdef _WIN32
+            HANDLE File = INVALID_HANDLE_VALUE;
+#else
+            int File = -1;
+#endif
+        };
+
+        // Rings CrashFlushAll() visits; fixed size so registration never allocates
+        const size_t kMaxCrashRings = 8;
+        std::atomic<CrashRing*> g_crashRings[kMaxCrashRings];
+
+        bool RegisterCrashRing(CrashRing* ring)
+        {
+            for (size_t i = 0; i < kMaxCrashRings; ++i) {
+                CrashRing* expected = nullptr;
+                if (g_crashRings[i].compare_exchange_strong(expected, ring)) return true;
+            }
+            return false;
+        }
+
+        void UnregisterCrashRing(CrashRing* ring)
+        {
+            for (size_t i = 0; i < kMaxCrashRings; ++i) {
+                CrashRing* expected = ring;
+                g_crashRings[i].compare_exchange_strong(expected, nullptr);
+            }
+        }
+    }
+
+    struct Client::State : std::enable_shared_from_this<Client::State>
+    {
+        ClientConfig Config;
+        std::shared_ptr<const TitleContext> Context;
+
+        mutable std::mutex Mutex;
+        std::condition_variable Idle;
+        EventQueue Events;
+        PurchaseQueue Purchases;
+        std::chrono::steady_clock::time_point BatchStarted;     // When the oldest unsent event was queued
+        std::chrono::steady_clock::time_point DrainAt;
+        std::chrono::steady_clock::time_point RetryAfter;       // Only Flush() sends before this after a failure
+        bool DrainScheduled = false;
+        bool Draining = false;
+        bool Stopping = false;
+        int ConsecutiveFailures = 0;    // Drain passes in a row that ended in a retryable failure
+        int PurchaseAttempts = 0;       // Failed sends of the purchase at the front of Purchases
+        uint64_t FlushRequested = 0;    // Flush() generations asked for
+        uint64_t FlushCompleted = 0;    // Generations a drain pass has fully gone through
+        bool ShutDown = false;
+        CancellationToken Cancel = CancellationToken::Create(); // Aborts the drain's request at the Shutdown() deadline
+
+        // What the drain is sending. It only reads these until it relocks, so Shutdown()
+        // can spill copies if the send outlives the deadline.
+        std::vector<QueuedEvent> InFlightEvents;
+        std::vector<PurchaseData> InFlightPurchases;
+        bool InFlightSpilled = false;
+        ShutdownReport Report;          // Drain sends that complete once Shutdown() has started
+
+        uint64_t NextSeq = 0;
+        uint64_t HeldFrom = UINT64_MAX;     // Oldest event Shutdown() is sending outside the queues
+        std::unique_ptr<CrashRing> CrashOwner;
+        std::atomic<CrashRing*> Crash{nullptr}; // Read without the lock by CrashFlush()
+
+        ~State()
+        {
+            if (CrashOwner) UnregisterCrashRing(CrashOwner.get());
+        }
+
+        // Caller holds Mutex
+        void Enqueue(QueuedEvent queued)
+        {
+            queued.Seq = NextSeq++;
+            if (CrashOwner) CrashOwner->Remember(queued);
+            Events.push_back(std::move(queued));
+        }
+
+        // Caller holds Mutex. Events are kept in Seq order, so the oldest pending one is at a front.
+        void UpdatePendingFrom()
+        {
+            if (!CrashOwner) return;
+            uint64_t from = std::min(HeldFrom, NextSeq);
+            if (!InFlightEvents.empty()) from = std::min(from, InFlightEvents.front().Seq);
+            if (!Events.empty()) from = std::min(from, Events.front().Seq);
+            CrashOwner->SetPendingFrom(from);
+        }
+
+        // Caller holds Mutex. An already scheduled earlier drain reschedules itself.
+        void ScheduleDrain(std::chrono::steady_clock::time_point due)
+        {
+            if (DrainScheduled && DrainAt <= due) return;
+            DrainScheduled = true;
+            DrainAt = due;
+            // Rounded up so the drain never wakes just before it is due
+            auto delay = std::chrono::duration_cast<std::chrono::milliseconds>(due - std::chrono::steady_clock::now());
+            if (delay.count() >= 0) delay += std::chrono::milliseconds(1);
+            std::weak_ptr<State> self = shared_from_this();
+            Internal::SubmitIOAfter(delay, [self]() {
+                if (std::shared_ptr<State> state = self.lock()) state->Drain();
+            });
+        }
+
+        void ScheduleNext()
+        {
+            std::chrono::steady_clock::time_point due;
+            if (!Purchases.empty() || Events.size() >= Config.MaxBatchEvents) due = std::chrono::steady_clock::now();
+            else if (!Events.empty()) due = BatchStarted + std::chrono::milliseconds(Config.FlushIntervalMs);
+            else return;
+            ScheduleDrain(std::max(due, RetryAfter));
+        }
+
+        void Drain();
+    };
+
+    void Client::State::Drain()
+    {
+        std::unique_lock<std::mutex> lock(Mutex);
+        auto now = std::chrono::steady_clock::now();
+        if (DrainScheduled && DrainAt <= now) DrainScheduled = false;
+        if (Draining || Stopping) return; // The running drain picks up whatever this one was for
+
+        Draining = true;
+        RequestOptions options;
+        options.Cancel = Cancel;
+        RequestScope scope(options);
+        uint64_t flushTarget = FlushRequested;
+        bool failed = false;
+        std::chrono::seconds serverDelay(0);   // Largest Retry-After of the failed sends
+        while (!Stopping && !failed) {
+            // Purchases first: they carry revenue and are never batched
+            if (!Purchases.empty()) {
+                InFlightPurchases.push_back(std::move(Purchases.front()));
+                Purchases.pop_front();
+                lock.unlock();
+                long status = 0;
+                std::string response = Context->RecordPurchase(InFlightPurchases.front(), &status);
+                lock.lock();
+                bool dead = false;
+                int attempts = 0;
+                if (!InFlightSpilled) {
+                    // Same rules as events: no response, 408, 429 or 5xx means try again later,
+                    // and only failures that say something about the purchase use up an attempt
+                    bool accepted = status >= 200 && status < 300;
+                    if (!accepted && UsesAttempt(status)) PurchaseAttempts++;
+                    if (Internal::IsRetryableStatus(status) && PurchaseAttempts < Config.MaxPurchaseAttempts) {
+                        Purchases.push_front(std::move(InFlightPurchases.front()));
+                        failed = true;
+                    } else {
+                        dead = !accepted;
+                        attempts = PurchaseAttempts;
+                        PurchaseAttempts = 0;
+                        if (Stopping) {
+                            if (accepted) Report.PurchasesFlushed++;
+                            else Report.PurchasesRejected++;
+                        }
+                    }
+                }
+                PurchaseData refused;
+                if (dead) refused = std::move(InFlightPurchases.front());
+                InFlightPurchases.clear();
+                if (dead) {
+                    lock.unlock();
+                    DeadLetter(Config, refused, status, response, attempts);
+                    lock.lock();
+                }
+                continue;
+            }
+
+            bool due = Events.size() >= Config.MaxBatchEvents || FlushCompleted < flushTarget ||
+                       BatchStarted + std::chrono::milliseconds(Config.FlushIntervalMs) <= std::chrono::steady_clock::now();
+            if (Events.empty() || !due) break;
+
+            size_t count = std::min(Events.size(), Config.MaxBatchEvents);
+            InFlightEvents.reserve(count);
+            for (size_t i = 0; i < count; ++i) InFlightEvents.push_back(std::move(Events[i]));
+            Events.erase(Events.begin(), Events.begin() + count);
+            BatchStarted = std::chrono::steady_clock::now();
+
+            lock.unlock();
+            std::vector<GameEventData> events;
+            events.reserve(InFlightEvents.size());
+            for (const QueuedEvent& queued : InFlightEvents) events.push_back(queued.Event);
+            BulkEventsResult result = Context->SendEventsBulk(events);
+            Internal::Counters().EventBatchesSent.fetch_add(1, std::memory_order_relaxed);
+            Internal::Counters().EventsAccepted.fetch_add(result.Accepted, std::memory_order_relaxed);
+            lock.lock();
+
+            std::vector<QueuedEvent> batch;
+            batch.swap(InFlightEvents);
+            if (InFlightSpilled) {
+                UpdatePendingFrom();
+                break; // Shutdown() already wrote the batch to the spool
+            }
+
+            // Accepted events are done; rejected and exhausted ones are dead-lettered; the rest go back in order
+            std::vector<size_t> dead;
+            size_t retried = 0;
+            for (size_t i = batch.size(); i-- > 0;) {
+                if (UsesAttempt(result.Statuses[i])) batch[i].Attempts++;
+                if (result.Outcomes[i] == EventOutcome::Rejected ||
+                    (result.Outcomes[i] == EventOutcome::Retry && batch[i].Attempts >= Config.MaxEventAttempts)) {
+                    dead.push_back(i);
+                } else if (result.Outcomes[i] == EventOutcome::Retry) {
+                    Events.push_front(std::move(batch[i]));
+                    retried++;
+                }
+            }
+            Internal::Counters().EventsRetried.fetch_add(retried, std::memory_order_relaxed);
+            if (result.Retryable > 0) {
+                failed = true;
+                serverDelay = std::max(serverDelay, result.RetryAfter);
+            }
+            if (Stopping) {
+                Report.EventsFlushed += result.Accepted;
+                Report.EventsDeadLettered += dead.size();
+            }
+
+            UpdatePendingFrom();
+
+            lock.unlock();
+            for (size_t k = dead.size(); k-- > 0;) {
+                size_t i = dead[k];
+                const std::string& error = result.Errors[i];
+                bool exhausted = result.Outcomes[i] == EventOutcome::Retry;
+                DeadLetter(Config, batch[i], result.Statuses[i], exhausted && error.empty() ? "retries_exhausted" : error);
+            }
+            lock.lock();
+        }
+
+        Draining = false;
+        FlushCompleted = std::max(FlushCompleted, flushTarget);
+        ConsecutiveFailures = failed ? std::min(ConsecutiveFailures + 1, 6) : 0;
+        if (!Stopping) {
+            if (FlushCompleted < FlushRequested) {
+                ScheduleDrain(std::chrono::steady_clock::now()); // Flush() came in mid-pass
+            } else if (failed) {
+                // Back off: one flush interval, doubling per failed pass up to 32, or longer if the server asked
+                auto backoff = std::chrono::milliseconds(Config.FlushIntervalMs) * (1 << (ConsecutiveFailures - 1));
+                backoff = std::max<std::chrono::milliseconds>(backoff, std::min(serverDelay, MaxRetryAfter));
+                RetryAfter = std::chrono::steady_clock::now() + backoff;
+                ScheduleDrain(RetryAfter);
+            } else {
+                ScheduleNext();
+            }
+        }
+        Idle.notify_all();
+    }
+
+    Client::Client(const ClientConfig& config) : Impl(std::make_shared<State>())
+    {
+        Impl->Config = config;
+        if (Impl->Config.MaxBatchEvents == 0) Impl->Config.MaxBatchEvents = 1;
+        Impl->Context = TitleContext::Get(config.TitleToken, config.TitleId);
+
+        if (config.SpoolPath.empty()) return;
+        std::lock_guard<std::mutex> lock(Impl->Mutex);
+        size_t replayed = ReplaySpool(config.SpoolPath, Impl->Events, Impl->Purchases);
+        if (replayed == 0) return;
+        for (QueuedEvent& queued : Impl->Events) queued.Seq = Impl->NextSeq++;
+        Internal::Counters().ItemsReplayed.fetch_add(replayed, std::memory_order_relaxed);
+        Impl->BatchStarted = std::chrono::steady_clock::now();
+        Impl->ScheduleNext();
+    }
+
+    Client::~Client()
+    {
+        std::lock_guard<std::mutex> lock(Impl->Mutex);
+        Impl->Stopping = true;
+        Impl->Idle.notify_all();
+    }
+
+    QueueResult Client::QueueEvent(GameEventData event)
+    {
+        std::string rawMetadata = event.MetadataJSON;
+        size_t errorOffset = 0;
+        QueueResult result = Internal::CheckMetadata(event.MetadataJSON, Impl->Config.InvalidMetadata, &errorOffset);
+        if (result == QueueResult::Rejected) return result;
+        if (result == QueueResult::Quarantined) {
+            Internal::JsonString item;
+            event.MetadataJSON.clear();
+            Internal::AppendEventJSON(item, event);
+            Internal::AppendQuarantine(Impl->Config.QuarantinePath, "event", errorOffset, rawMetadata, item);
+            return result;
+        }
+
+        std::lock_guard<std::mutex> lock(Impl->Mutex);
+        if (Impl->ShutDown) return QueueResult::Rejected;
+        Internal::Counters().EventsQueued.fetch_add(1, std::memory_order_relaxed);
+        if (Impl->Events.empty()) Impl->BatchStarted = std::chrono::steady_clock::now();
+        QueuedEvent queued;
+        queued.Event = std::move(event);
+        Impl->Enqueue(std::move(queued));
+        if (Impl->Config.MaxQueuedEvents > 0 && Impl->Events.size() > Impl->Config.MaxQueuedEvents) {
+            Impl->Events.pop_front();
+            Internal::Counters().EventsDropped.fetch_add(1, std::memory_order_relaxed);
+            Impl->UpdatePendingFrom();
+        }
+        if (!Impl->Draining) Impl->ScheduleNext();
+        return result;
+    }
+
+    QueueResult Client::QueuePurchase(PurchaseData purchase)
+    {
+        std::string rawMetadata = purchase.MetadataJSON;
+        size_t errorOffset = 0;
+        QueueResult result = Internal::CheckMetadata(purchase.MetadataJSON, Impl->Config.InvalidMetadata, &errorOffset);
+        if (result == QueueResult::Rejected) return result;
+        if (result == QueueResult::Quarantined) {
+            purchase.MetadataJSON.clear();
+            std::string json = PurchaseToJSON(purchase);
+            Internal::AppendQuarantine(Impl->Config.QuarantinePath, "purchase", errorOffset, rawMetadata,
+                                       Internal::JsonString(json.data(), json.size()));
+            return result;
+        }
+
+        std::lock_guard<std::mutex> lock(Impl->Mutex);
+        if (Impl->ShutDown) return QueueResult::Rejected;
+        Impl->Purchases.push_back(std::move(purchase));
+        if (!Impl->Draining) Impl->ScheduleNext();
+        return result;
+    }
+
+    void Client::Flush()
+    {
+        std::unique_lock<std::mutex> lock(Impl->Mutex);
+        uint64_t target = ++Impl->FlushRequested;
+        Impl->ScheduleDrain(std::chrono::steady_clock::now());
+        Impl->Idle.wait(lock, [this, target]() { return Impl->Stopping || Impl->FlushCompleted >= target; });
+    }
+
+    ShutdownReport Client::Shutdown(std::chrono::steady_clock::time_point deadline)
+    {
+        ShutdownReport report;
+        std::vector<PurchaseData> purchases;
+        std::vector<QueuedEvent> events;
+        int frontAttempts = 0;
+        {
+            std::lock_guard<std::mutex> lock(Impl->Mutex);
+            if (Impl->ShutDown) return report;
+            Impl->ShutDown = true;
+            Impl->Stopping = true; // A running drain finishes its current send and stops
+            purchases.assign(std::make_move_iterator(Impl->Purchases.begin()), std::make_move_iterator(Impl->Purchases.end()));
+            events.assign(std::make_move_iterator(Impl->Events.begin()), std::make_move_iterator(Impl->Events.end()));
+            Impl->Purchases.clear();
+            Impl->Events.clear();
+            frontAttempts = Impl->PurchaseAttempts;
+            Impl->PurchaseAttempts = 0;
+            if (!events.empty()) Impl->HeldFrom = events.front().Seq;
+            Impl->Idle.notify_all();
+        }
+
+        // Purchases are claimed first, so they are on the wire before any event batch
+        const ClientConfig& config = Impl->Config;
+        size_t batches = (events.size() + config.MaxBatchEvents - 1) / config.MaxBatchEvents;
+        std::vector<long> purchaseStatus(purchases.size(), 0); // 0: never sent or no response
+        std::vector<std::string> purchaseResponses(purchases.size());
+        std::vector<BulkEventsResult> results(batches); // Empty Outcomes: never sent
+        Internal::ParallelFor(purchases.size() + batches, config.ShutdownConcurrency, [&](size_t index) {
+            if (std::chrono::steady_clock::now() >= deadline) return;
+            RequestOptions options;
+            options.Deadline = deadline;
+            RequestScope scope(options);
+            if (index < purchases.size()) {
+                purchaseResponses[index] = Impl->Context->RecordPurchase(purchases[index], &purchaseStatus[index]);
+                return;
+            }
+            size_t batch = index - purchases.size();
+            size_t first = batch * config.MaxBatchEvents;
+            size_t last = std::min(first + config.MaxBatchEvents, events.size());
+            std::vector<GameEventData> sending;
+            sending.reserve(last - first);
+            for (size_t i = first; i < last; ++i) sending.push_back(events[i].Event);
+            results[batch] = Impl->Context->SendEventsBulk(sending);
+        }, Internal::IoExecutor());
+
+        std::vector<PurchaseData> spillPurchases;
+        std::vector<QueuedEvent> spillEvents;
+        for (size_t i = 0; i < purchases.size(); ++i) {
+            long status = purchaseStatus[i];
+            if (status >= 200 && status < 300) {
+                report.PurchasesFlushed++;
+            } else if (!Internal::IsRetryableStatus(status)) {
+                report.PurchasesRejected++;
+                DeadLetter(config, purchases[i], status, purchaseResponses[i], (i == 0 ? frontAttempts : 0) + 1);
+            } else {
+                spillPurchases.push_back(std::move(purchases[i]));
+            }
+        }
+        for (size_t batch = 0; batch < batches; ++batch) {
+            const BulkEventsResult& result = results[batch];
+            size_t first = batch * config.MaxBatchEvents;
+            size_t last = std::min(first + config.MaxBatchEvents, events.size());
+            if (result.Outcomes.empty()) {
+                for (size_t i = first; i < last; ++i) spillEvents.push_back(std::move(events[i]));
+                continue;
+            }
+            Internal::Counters().EventBatchesSent.fetch_add(1, std::memory_order_relaxed);
+            Internal::Counters().EventsAccepted.fetch_add(result.Accepted, std::memory_order_relaxed);
+            for (size_t i = first; i < last; ++i) {
+                EventOutcome outcome = result.Outcomes[i - first];
+                const std::string& error = result.Errors[i - first];
+                if (UsesAttempt(result.Statuses[i - first])) events[i].Attempts++;
+                if (outcome == EventOutcome::Accepted) {
+                    report.EventsFlushed++;
+                } else if (outcome == EventOutcome::Rejected || events[i].Attempts >= config.MaxEventAttempts) {
+                    DeadLetter(config, events[i], result.Statuses[i - first],
+                               outcome == EventOutcome::Retry && error.empty() ? "retries_exhausted" : error);
+                    report.EventsDeadLettered++;
+                } else {
+                    spillEvents.push_back(std::move(events[i]));
+                }
+            }
+        }
+
+        {
+            std::unique_lock<std::mutex> lock(Impl->Mutex);
+            if (!Impl->Idle.wait_until(lock, deadline, [this]() { return !Impl->Draining; })) {
+                // Spill copies of what the drain is still sending and abort it. The server
+                // may yet accept them, so these can arrive twice.
+                spillPurchases.insert(spillPurchases.end(), Impl->InFlightPurchases.begin(), Impl->InFlightPurchases.end());
+                spillEvents.insert(spillEvents.end(), Impl->InFlightEvents.begin(), Impl->InFlightEvents.end());
+                Impl->InFlightSpilled = true;
+                Impl->Cancel.Cancel();
+            }
+            // Sends the drain finished, and anything it put back
+            std::move(Impl->Purchases.begin(), Impl->Purchases.end(), std::back_inserter(spillPurchases));
+            std::move(Impl->Events.begin(), Impl->Events.end(), std::back_inserter(spillEvents));
+            Impl->Purchases.clear();
+            Impl->Events.clear();
+            report.PurchasesFlushed += Impl->Report.PurchasesFlushed;
+            report.PurchasesRejected += Impl->Report.PurchasesRejected;
+            report.EventsFlushed += Impl->Report.EventsFlushed;
+            report.EventsDeadLettered += Impl->Report.EventsDeadLettered;
+        }
+
+        size_t leftover = spillPurchases.size() + spillEvents.size();
+        if (leftover > 0) {
+            report.DeadlineReached = std::chrono::steady_clock::now() >= deadline;
+            std::string records;
+            for (const PurchaseData& purchase : spillPurchases) AppendSpoolRecord(records, purchase);
+            for (const QueuedEvent& queued : spillEvents) AppendSpoolRecord(records, queued);
+            if (!config.SpoolPath.empty() && AppendSpool(config.SpoolPath, records)) {
+                report.PurchasesSpilled = spillPurchases.size();
+                report.EventsSpilled = spillEvents.size();
+                Internal::Counters().ItemsSpilled.fetch_add(leftover, std::memory_order_relaxed);
+            } else {
+                report.Lost = leftover;
+            }
+        }
+
+        // Everything is settled now, so a later crash flush has nothing to add
+        std::lock_guard<std::mutex> lock(Impl->Mutex);
+        Impl->HeldFrom = UINT64_MAX;
+        Impl->UpdatePendingFrom();
+        return report;
+    }
+
+    bool Client::EnableCrashFlush()
+    {
+        std::lock_guard<std::mutex> lock(Impl->Mutex);
+        if (Impl->CrashOwner) return true;
+        if (Impl->Config.SpoolPath.empty() || Impl->Config.CrashRingEvents == 0) return false;
+
+        std::unique_ptr<CrashRing> ring(new CrashRing(Impl->Config.CrashRingEvents));
+        if (!ring->Open(Impl->Config.SpoolPath)) return false;
+        for (const QueuedEvent& queued : Impl->InFlightEvents) ring->Remember(queued);
+        for (const QueuedEvent& queued : Impl->Events) ring->Remember(queued);
+        RegisterCrashRing(ring.get());
+        Impl->Crash.store(ring.get(), std::memory_order_release);
+        Impl->CrashOwner = std::move(ring);
+        Impl->UpdatePendingFrom();
+        return true;
+    }
+
+    void Client::CrashFlush() const
+    {
+        if (CrashRing* ring = Impl->Crash.load(std::memory_order_acquire)) ring->Flush();
+    }
+
+    void CrashFlushAll()
+    {
+        for (size_t i = 0; i < kMaxCrashRings; ++i) {
+            if (CrashRing* ring = g_crashRings[i].load(std::memory_order_acquire)) ring->Flush();
+        }
+    }
+
+    size_t Client::GetQueuedCount() const
+    {
+        std::lock_guard<std::mutex> lock(Impl->Mutex);
+        return Impl->Events.size() + Impl->Purchases.size();
+    }
+
+} // namespace GlitchSDK
@@ -0,0 +1,419 @@
+#include "GlitchSDK.h"
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <queue>
+#include <thread>
+
+#ifdef _WIN32
+    #include <windows.h>
+#elif defined(__APPLE__)
+    #include <pthread.h>
+    #include <pthread/qos.h>
+#elif defined(__linux__)
+    #include <sys/resource.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+#endif
+
+namespace GlitchSDK
+{
+    // --- Work-stealing executor ---
+
+    namespace
+    {
+        typedef std::function<void()> Task;
+        typedef std::deque<Task, Internal::TaggedAllocator<Task, MemoryTag::Queues> > TaskDeque;
+
+        // Set once the SDK's static pools start being destroyed at process exit
+        std::atomic<bool> g_staticTeardown(false);
+
+        void ApplyThreadPriority(ThreadPriority priority)
+        {
+            if (priority == ThreadPriority::Normal) return;
+#ifdef _WIN32
+            SetThreadPriority(GetCurrentThread(),
+                              priority == ThreadPriority::Idle ? THREAD_PRIORITY_IDLE : THREAD_PRIORITY_BELOW_NORMAL);
+#elif defined(__APPLE__)
+            pthread_set_qos_class_self_np(priority == ThreadPriority::Idle ? QOS_CLASS_BACKGROUND : QOS_CLASS_UTILITY, 0);
+#elif defined(__linux__)
+            // Linux applies nice values per thread
+            setpriority(PRIO_PROCESS, (id_t)syscall(SYS_gettid), priority == ThreadPriority::Idle ? 19 : 10);
+#endif
+        }
+    }
+
+    struct WorkStealingExecutor::State
+    {
+        struct WorkerQueue
+        {
+            std::mutex Mutex;
+            TaskDeque Tasks;
+        };
+
+        std::vector<std::unique_ptr<WorkerQueue> > Queues;
+        std::vector<std::thread> Workers;
+        std::atomic<size_t> Queued;
+        std::atomic<size_t> NextQueue;
+        std::mutex SleepMutex;
+        std::condition_variable Wake;
+        bool Stopping = false;
+
+        State() : Queued(0), NextQueue(0) {}
+
+        bool TryPop(size_t index, Task& task)
+        {
+            // Own work newest-first for cache locality, stolen work oldest-first
+            {
+                WorkerQueue& own = *Queues[index];
+                std::lock_guard<std::mutex> lock(own.Mutex);
+                if (!own.Tasks.empty()) {
+                    task = std::move(own.Tasks.back());
+                    own.Tasks.pop_back();
+                    return true;
+                }
+            }
+            for (size_t offset = 1; offset < Queues.size(); ++offset) {
+                WorkerQueue& victim = *Queues[(index + offset) % Queues.size()];
+                std::lock_guard<std::mutex> lock(victim.Mutex);
+                if (!victim.Tasks.empty()) {
+                    task = std::move(victim.Tasks.front());
+                    victim.Tasks.pop_front();
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        static void Run(std::shared_ptr<State> state, size_t index, ThreadPriority priority);
+    };
+
+    namespace
+    {
+        thread_local WorkStealingExecutor::State* t_pool = nullptr;
+        thread_local size_t t_workerIndex = 0;
+    }
+
+    void WorkStealingExecutor::State::Run(std::shared_ptr<State> state, size_t index, ThreadPriority priority)
+    {
+        t_pool = state.get();
+        t_workerIndex = index;
+        ApplyThreadPriority(priority);
+
+        for (;;) {
+            Task task;
+            if (state->TryPop(index, task)) {
+                state->Queued.fetch_sub(1);
+                try {
+                    task();
+                } catch (...) {
+                    // A throwing task must not take the worker down with it
+                }
+                continue;
+            }
+
+            // Stop only once the queues are empty, so tasks queued before shutdown still run
+            std::unique_lock<std::mutex> lock(state->SleepMutex);
+            state->Wake.wait(lock, [&state]() { return state->Stopping || state->Queued.load() > 0; });
+            if (state->Stopping && state->Queued.load() == 0) return;
+        }
+    }
+
+    WorkStealingExecutor::WorkStealingExecutor(const ExecutorConfig& config) : Impl(std::make_shared<State>())
+    {
+        unsigned threads = config.Threads;
+        if (threads == 0) threads = std::max(2u, std::thread::hardware_concurrency() / 2);
+
+        for (unsigned i = 0; i < threads; ++i) Impl->Queues.push_back(std::unique_ptr<State::WorkerQueue>(new State::WorkerQueue()));
+        for (unsigned i = 0; i < threads; ++i) {
+            Impl->Workers.push_back(std::thread(&State::Run, Impl, size_t(i), config.Priority));
+        }
+    }
+
+    WorkStealingExecutor::~WorkStealingExecutor()
+    {
+        // At exit the statics queued tasks rely on (TitleContext cache, transport) may
+        // already be gone, so only tasks already running get to finish
+        if (g_staticTeardown.load()) {
+            for (auto& queue : Impl->Queues) {
+                std::lock_guard<std::mutex> lock(queue->Mutex);
+                Impl->Queued.fetch_sub(queue->Tasks.size());
+                queue->Tasks.clear();
+            }
+        }
+        {
+            std::lock_guard<std::mutex> lock(Impl->SleepMutex);
+            Impl->Stopping = true;
+        }
+        Impl->Wake.notify_all();
+        for (std::thread& worker : Impl->Workers) {
+            if (worker.get_id() == std::this_thread::get_id()) worker.detach(); // Destroyed from one of its own tasks
+            else worker.join();
+        }
+    }
+
+    void WorkStealingExecutor::Submit(std::function<void()> task)
+    {
+        size_t index = t_pool == Impl.get() ? t_workerIndex : Impl->NextQueue.fetch_add(1) % Impl->Queues.size();
+        {
+            State::WorkerQueue& queue = *Impl->Queues[index];
+            std::lock_guard<std::mutex> lock(queue.Mutex);
+            queue.Tasks.push_back(std::move(task));
+        }
+        Impl->Queued.fetch_add(1);
+
+        // Taking the lock orders this wakeup after a worker's predicate check
+        { std::lock_guard<std::mutex> lock(Impl->SleepMutex); }
+        Impl->Wake.notify_one();
+    }
+
+    unsigned WorkStealingExecutor::GetThreadCount() const
+    {
+        return unsigned(Impl->Workers.size());
+    }
+
+    // --- Active executor ---
+
+    namespace
+    {
+        // Marks static teardown before the pool it holds is released
+        struct StaticExecutor
+        {
+            explicit StaticExecutor(std::shared_ptr<IExecutor> executor) : Executor(std::move(executor)) {}
+            ~StaticExecutor() { g_staticTeardown.store(true); }
+            std::shared_ptr<IExecutor> Executor;
+        };
+
+        std::shared_ptr<IExecutor>& ExecutorSlot()
+        {
+            static StaticExecutor slot(std::make_shared<WorkStealingExecutor>());
+            return slot.Executor;
+        }
+
+        // SDK-owned threads for network I/O, so blocking sends never hold a host job-system worker
+        const unsigned IoThreads = 8;
+
+        const std::shared_ptr<IExecutor>& IoSlot()
+        {
+            static StaticExecutor slot([]() {
+                ExecutorConfig config;
+                config.Threads = IoThreads;
+                return std::make_shared<WorkStealingExecutor>(config);
+            }());
+            return slot.Executor;
+        }
+
+        // Waits for delayed submissions; the tasks themselves run on the I/O pool
+        class DelayedSubmitter
+        {
+        public:
+            ~DelayedSubmitter()
+            {
+                {
+                    std::lock_guard<std::mutex> lock(Mutex);
+                    Stopping = true;
+                }
+                Wake.notify_all();
+                if (Worker.joinable()) Worker.join();
+            }
+
+            void Add(std::chrono::milliseconds delay, std::function<void()> task)
+            {
+                std::lock_guard<std::mutex> lock(Mutex);
+                Entry entry;
+                entry.Due = std::chrono::steady_clock::now() + delay;
+                entry.Sequence = NextSequence++;
+                entry.Work = std::move(task);
+                Timers.push(std::move(entry));
+                if (!Worker.joinable()) Worker = std::thread(&DelayedSubmitter::Run, this);
+                Wake.notify_all();
+            }
+
+        private:
+            struct Entry
+            {
+                std::chrono::steady_clock::time_point Due;
+                uint64_t Sequence;
+                std::function<void()> Work;
+
+                bool operator>(const Entry& other) const
+                {
+                    return Due != other.Due ? Due > other.Due : Sequence > other.Sequence;
+                }
+            };
+
+            void Run()
+            {
+                std::unique_lock<std::mutex> lock(Mutex);
+                while (!Stopping) {
+                    if (Timers.empty()) {
+                        Wake.wait(lock);
+                        continue;
+                    }
+                    // Copied: Add() may reallocate the heap while this waits
+                    std::chrono::steady_clock::time_point due = Timers.top().Due;
+                    if (due > std::chrono::steady_clock::now()) {
+                        Wake.wait_until(lock, due);
+                        continue;
+                    }
+                    std::function<void()> task = Timers.top().Work;
+                    Timers.pop();
+                    lock.unlock();
+                    IoSlot()->Submit(std::move(task));
+                    lock.lock();
+                }
+            }
+
+            std::mutex Mutex;
+            std::condition_variable Wake;
+            std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry> > Timers;
+            uint64_t NextSequence = 0;
+            std::thread Worker;
+            bool Stopping = false;
+        };
+
+        DelayedSubmitter& Delayed()
+        {
+            IoSlot(); // Constructed first so it outlives the submitter's thread at exit
+            static DelayedSubmitter submitter;
+            return submitter;
+        }
+    }
+
+    void SetExecutor(std::shared_ptr<IExecutor> executor)
+    {
+        if (!executor) executor = std::make_shared<WorkStealingExecutor>();
+        std::atomic_store(&ExecutorSlot(), executor);
+    }
+
+    std::shared_ptr<IExecutor> GetExecutor()
+    {
+        return std::atomic_load(&ExecutorSlot());
+    }
+
+    namespace Internal
+    {
+        std::shared_ptr<IExecutor> IoExecutor()
+        {
+            return IoSlot();
+        }
+
+        void SubmitIO(std::function<void()> task)
+        {
+            IoSlot()->Submit(std::move(task));
+        }
+
+        void SubmitIOAfter(std::chrono::milliseconds delay, std::function<void()> task)
+        {
+            if (delay.count() <= 0) IoSlot()->Submit(std::move(task));
+            else Delayed().Add(delay, std::move(task));
+        }
+
+        void RunOnExecutor(const std::function<void()>& task)
+        {
+            struct Job
+            {
+                std::mutex Mutex;
+                std::condition_variable Done;
+                bool Finished = false;
+                bool Dropped = false;       // The executor discarded the task without running it
+                std::exception_ptr Error;
+            };
+            // Destroyed with the last copy of the submitted task: if that never ran, the caller runs it
+            struct Claim
+            {
+                explicit Claim(std::shared_ptr<Job> job) : Owner(std::move(job)) {}
+                ~Claim()
+                {
+                    std::lock_guard<std::mutex> lock(Owner->Mutex);
+                    if (Owner->Finished) return;
+                    Owner->Finished = Owner->Dropped = true;
+                    Owner->Done.notify_all();
+                }
+                std::shared_ptr<Job> Owner;
+            };
+
+            std::shared_ptr<Job> job = std::make_shared<Job>();
+            {
+                std::shared_ptr<Claim> claim = std::make_shared<Claim>(job);
+                const std::function<void()>* run = &task;
+                GetExecutor()->Submit([claim, run]() {
+                    std::exception_ptr error;
+                    try {
+                        (*run)();
+                    } catch (...) {
+                        error = std::current_exception();
+                    }
+                    std::lock_guard<std::mutex> lock(claim->Owner->Mutex);
+                    claim->Owner->Error = error;
+                    claim->Owner->Finished = true;
+                    claim->Owner->Done.notify_all();
+                });
+            }
+
+            std::unique_lock<std::mutex> lock(job->Mutex);
+            job->Done.wait(lock, [&job]() { return job->Finished; });
+            if (job->Dropped) {
+                lock.unlock();
+                task();
+                return;
+            }
+            if (job->Error) std::rethrow_exception(job->Error);
+        }
+
+        void ParallelFor(size_t count, size_t maxConcurrent, const std::function<void(size_t)>& body,
+                         std::shared_ptr<IExecutor> executor)
+        {
+            // Helpers may start after every index is done, so they reach body only through a claimed index
+            struct Progress
+            {
+                explicit Progress(size_t count) : Count(count), Next(0), Failed(false), Completed(0) {}
+                const size_t Count;
+                std::atomic<size_t> Next;
+                std::atomic<bool> Failed;
+                size_t Completed;
+                std::exception_ptr Error;   // First exception thrown by body
+                std::mutex Mutex;
+                std::condition_variable Done;
+            };
+            std::shared_ptr<Progress> progress = std::make_shared<Progress>(count);
+            const std::function<void(size_t)>* run = &body;
+            auto worker = [progress, run]() {
+                for (size_t i = progress->Next.fetch_add(1); i < progress->Count; i = progress->Next.fetch_add(1)) {
+                    // Every claimed index is counted, even if body throws, so the caller's wait
+                    // always ends and no helper touches body after the caller has returned
+                    try {
+                        if (!progress->Failed.load()) (*run)(i);
+                    } catch (...) {
+                        std::lock_guard<std::mutex> lock(progress->Mutex);
+                        if (!progress->Error) progress->Error = std::current_exception();
+                        progress->Failed.store(true);
+                    }
+                    std::lock_guard<std::mutex> lock(progress->Mutex);
+                    if (++progress->Completed == progress->Count) progress->Done.notify_all();
+                }
+            };
+
+            // The caller works too and waits on indices rather than helpers, so calling from a pool thread cannot deadlock
+            size_t threads = std::min(count, maxConcurrent > 0 ? maxConcurrent : size_t(1));
+            if (threads > 1) {
+                if (!executor) executor = GetExecutor();
+                for (size_t i = 1; i < threads; ++i) executor->Submit(worker);
+            }
+            worker();
+
+            std::unique_lock<std::mutex> lock(progress->Mutex);
+            progress->Done.wait(lock, [&progress]() { return progress->Completed == progress->Count; });
+            if (progress->Error) std::rethrow_exception(progress->Error);
+        }
+
+        size_t ExecutorConcurrency()
+        {
+            unsigned concurrency = GetExecutor()->GetConcurrency();
+            if (concurrency == 0) concurrency = std::thread::hardware_concurrency();
+            return concurrency > 0 ? concurrency : 1;
+        }
+    }
+
+} // namespace GlitchSDK
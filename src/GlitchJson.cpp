@@ -0,0 +1,383 @@
+#include "GlitchSDK.h"
+#include <chrono>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define GLITCH_JSON_SSE2 1
+#elif defined(__aarch64__) || defined(_M_ARM64)
+    #include <arm_neon.h>
+    #define GLITCH_JSON_NEON 1
+#endif
+
+#if defined(_MSC_VER) && defined(GLITCH_JSON_SSE2)
+    #include <intrin.h>
+#endif
+
+namespace GlitchSDK
+{
+    // --- JSON validation ---
+
+    namespace
+    {
+        // Deeper documents are refused rather than risking the stack
+        const int MaxDepth = 256;
+
+        // Length of the well-formed UTF-8 sequence (RFC 3629) starting at p, or 0
+        size_t Utf8SequenceLength(const unsigned char* p, const unsigned char* end)
+        {
+            unsigned char lead = p[0];
+            size_t length;
+            unsigned char low = 0x80, high = 0xBF; // Allowed range of the second byte
+            if (lead < 0x80) return 1;
+            else if (lead >= 0xC2 && lead <= 0xDF) length = 2;
+            else if (lead == 0xE0) { length = 3; low = 0xA0; }
+            else if (lead == 0xED) { length = 3; high = 0x9F; } // No UTF-16 surrogates
+            else if (lead >= 0xE1 && lead <= 0xEF) length = 3;
+            else if (lead == 0xF0) { length = 4; low = 0x90; }
+            else if (lead == 0xF4) { length = 4; high = 0x8F; } // Nothing above U+10FFFF
+            else if (lead >= 0xF1 && lead <= 0xF3) length = 4;
+            else return 0;
+
+            if (size_t(end - p) < length) return 0;
+            if (p[1] < low || p[1] > high) return 0;
+            for (size_t i = 2; i < length; ++i) {
+                if ((p[i] & 0xC0) != 0x80) return 0;
+            }
+            return length;
+        }
+
+        bool IsHex(unsigned char c)
+        {
+            return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+        }
+
+        bool IsDigit(unsigned char c)
+        {
+            return c >= '0' && c <= '9';
+        }
+
+        // Skips plain ASCII string content ('"', '\\', control and non-ASCII bytes stop it)
+        const unsigned char* SkipPlainStringBytes(const unsigned char* p, const unsigned char* end)
+        {
+#if defined(GLITCH_JSON_SSE2)
+            const __m128i quote = _mm_set1_epi8('"');
+            const __m128i backslash = _mm_set1_epi8('\\');
+            const __m128i space = _mm_set1_epi8(0x20);
+            while (end - p >= 16) {
+                __m128i chunk = _mm_loadu_si128((const __m128i*)p);
+                // Signed compare: bytes >= 0x80 are negative, so they count as "below space" too
+                __m128i special = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)),
+                                               _mm_cmplt_epi8(chunk, space));
+                int mask = _mm_movemask_epi8(special);
+                if (mask != 0) {
+#if defined(_MSC_VER)
+                    unsigned long index;
+                    _BitScanForward(&index, (unsigned long)mask);
+                    return p + index;
+#else
+                    return p + __builtin_ctz((unsigned)mask);
+#endif
+                }
+                p += 16;
+            }
+#elif defined(GLITCH_JSON_NEON)
+            const uint8x16_t quote = vdupq_n_u8('"');
+            const uint8x16_t backslash = vdupq_n_u8('\\');
+            const uint8x16_t space = vdupq_n_u8(0x20);
+            const uint8x16_t ascii = vdupq_n_u8(0x80);
+            while (end - p >= 16) {
+                uint8x16_t chunk = vld1q_u8(p);
+                uint8x16_t special = vorrq_u8(vorrq_u8(vceqq_u8(chunk, quote), vceqq_u8(chunk, backslash)),
+                                              vorrq_u8(vcltq_u8(chunk, space), vcgeq_u8(chunk, ascii)));
+                if (vmaxvq_u8(special) != 0) break; // The scalar loop below finds the byte
+                p += 16;
+            }
+#endif
+            while (p < end && *p != '"' && *p != '\\' && *p >= 0x20 && *p < 0x80) ++p;
+            return p;
+        }
+
+        class JsonValidator
+        {
+        public:
+            JsonValidator(const unsigned char* begin, const unsigned char* end) : P(begin), End(end) {}
+
+            bool Document()
+            {
+                SkipWhitespace();
+                if (!Value(0)) return false;
+                SkipWhitespace();
+                return P == End;
+            }
+
+            const unsigned char* Position() const { return P; }
+
+        private:
+            void SkipWhitespace()
+            {
+                while (P < End && (*P == ' ' || *P == '\n' || *P == '\r' || *P == '\t')) ++P;
+            }
+
+            bool Value(int depth)
+            {
+                if (P == End) return false;
+                switch (*P) {
+                    case '{': return Object(depth + 1);
+                    case '[': return Array(depth + 1);
+                    case '"': return String();
+                    case 't': return Literal("true", 4);
+                    case 'f': return Literal("false", 5);
+                    case 'n': return Literal("null", 4);
+                    default: return Number();
+                }
+            }
+
+            bool Object(int depth)
+            {
+                if (depth > MaxDepth) return false;
+                ++P;
+                SkipWhitespace();
+                if (P < End && *P == '}') {
+                    ++P;
+                    return true;
+                }
+                for (;;) {
+                    if (P == End || *P != '"' || !String()) return false;
+                    SkipWhitespace();
+                    if (P == End || *P != ':') return false;
+                    ++P;
+                    SkipWhitespace();
+                    if (!Value(depth)) return false;
+                    SkipWhitespace();
+                    if (P == End) return false;
+                    if (*P == '}') {
+                        ++P;
+                        return true;
+                    }
+                    if (*P != ',') return false;
+                    ++P;
+                    SkipWhitespace();
+                }
+            }
+
+            bool Array(int depth)
+            {
+                if (depth > MaxDepth) return false;
+                ++P;
+                SkipWhitespace();
+                if (P < End && *P == ']') {
+                    ++P;
+                    return true;
+                }
+                for (;;) {
+                    if (!Value(depth)) return false;
+                    SkipWhitespace();
+                    if (P == End) return false;
+                    if (*P == ']') {
+                        ++P;
+                        return true;
+                    }
+                    if (*P != ',') return false;
+                    ++P;
+                    SkipWhitespace();
+                }
+            }
+
+            bool String()
+            {
+                ++P; // Opening quote
+                for (;;) {
+                    P = SkipPlainStringBytes(P, End);
+                    if (P == End) return false;
+                    unsigned char c = *P;
+                    if (c == '"') {
+                        ++P;
+                        return true;
+                    }
+                    if (c == '\\') {
+                        if (End - P < 2) return false;
+                        unsigned char escaped = P[1];
+                        if (escaped == 'u') {
+                            if (End - P < 6 || !IsHex(P[2]) || !IsHex(P[3]) || !IsHex(P[4]) || !IsHex(P[5])) return false;
+                            P += 6;
+                        } else if (escaped != 0 && strchr("\"\\/bfnrt", escaped)) {
+                            P += 2;
+                        } else {
+                            return false;
+                        }
+                    } else if (c < 0x20) {
+                        return false; // Raw control characters must be escaped
+                    } else {
+                        size_t length = Utf8SequenceLength(P, End);
+                        if (length == 0) return false;
+                        P += length;
+                    }
+                }
+            }
+
+            bool Number()
+            {
+                if (P < End && *P == '-') ++P;
+                if (P == End) return false;
+                if (*P == '0') {
+                    ++P;
+                } else if (IsDigit(*P)) {
+                    while (P < End && IsDigit(*P)) ++P;
+                } else {
+                    return false;
+                }
+                if (P < End && *P == '.') {
+                    ++P;
+                    if (P == End || !IsDigit(*P)) return false;
+                    while (P < End && IsDigit(*P)) ++P;
+                }
+                if (P < End && (*P == 'e' || *P == 'E')) {
+                    ++P;
+                    if (P < End && (*P == '+' || *P == '-')) ++P;
+                    if (P == End || !IsDigit(*P)) return false;
+                    while (P < End && IsDigit(*P)) ++P;
+                }
+                return true;
+            }
+
+            bool Literal(const char* literal, size_t length)
+            {
+                if (size_t(End - P) < length || memcmp(P, literal, length) != 0) return false;
+                P += length;
+                return true;
+            }
+
+            const unsigned char* P;
+            const unsigned char* End;
+        };
+    }
+
+    bool IsValidJSON(const char* data, size_t size, size_t* errorOffset)
+    {
+        const unsigned char* begin = (const unsigned char*)data;
+        JsonValidator validator(begin, begin + size);
+        bool valid = validator.Document();
+        if (errorOffset) *errorOffset = valid ? 0 : size_t(validator.Position() - begin);
+        return valid;
+    }
+
+    // --- Metadata policy ---
+
+    namespace
+    {
+        std::string UtcTimestamp()
+        {
+            std::time_t now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+            char timestamp[32] = "";
+            std::tm utc;
+#ifdef _WIN32
+            gmtime_s(&utc, &now);
+#else
+            gmtime_r(&now, &utc);
+#endif
+            std::strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%SZ", &utc);
+            return timestamp;
+        }
+
+        void AppendLine(const std::string& path, const Internal::JsonString& text)
+        {
+            // Queues on several threads may write to the same file
+            static std::mutex mutex;
+            std::lock_guard<std::mutex> lock(mutex);
+            std::ofstream file(path.c_str(), std::ios::binary | std::ios::app);
+            file.write(text.data(), std::streamsize(text.size()));
+        }
+    }
+
+    namespace Internal
+    {
+        std::string WrapAsJSONString(const std::string& raw)
+        {
+            static const char hex[] = "0123456789abcdef";
+            const unsigned char* p = (const unsigned char*)raw.data();
+            const unsigned char* end = p + raw.size();
+
+            std::string wrapped;
+            wrapped.reserve(raw.size() + 2);
+            wrapped += '"';
+            while (p < end) {
+                unsigned char c = *p;
+                if (c == '"') wrapped += "\\\"";
+                else if (c == '\\') wrapped += "\\\\";
+                else if (c == '\n') wrapped += "\\n";
+                else if (c == '\r') wrapped += "\\r";
+                else if (c == '\t') wrapped += "\\t";
+                else if (c < 0x20) {
+                    wrapped += "\\u00";
+                    wrapped += hex[c >> 4];
+                    wrapped += hex[c & 0xF];
+                } else if (c >= 0x80) {
+                    size_t length = Utf8SequenceLength(p, end);
+                    if (length == 0) {
+                        wrapped += "\\ufffd";
+                        ++p;
+                        continue;
+                    }
+                    wrapped.append((const char*)p, length);
+                    p += length;
+                    continue;
+                } else {
+                    wrapped += char(c);
+                }
+                ++p;
+            }
+            wrapped += '"';
+            return wrapped;
+        }
+
+        QueueResult CheckMetadata(std::string& metadata, MetadataPolicy policy, size_t* errorOffset)
+        {
+            if (metadata.empty() || IsValidJSON(metadata, errorOffset)) return QueueResult::Queued;
+
+            switch (policy) {
+                case MetadataPolicy::Reject:
+                    Counters().MetadataRejected.fetch_add(1, std::memory_order_relaxed);
+                    return QueueResult::Rejected;
+                case MetadataPolicy::Quarantine:
+                    Counters().MetadataQuarantined.fetch_add(1, std::memory_order_relaxed);
+                    return QueueResult::Quarantined;
+                case MetadataPolicy::WrapAsString:
+                default:
+                    Counters().MetadataWrapped.fetch_add(1, std::memory_order_relaxed);
+                    metadata = WrapAsJSONString(metadata);
+                    return QueueResult::Wrapped;
+            }
+        }
+
+        void AppendQuarantine(const std::string& path, const char* kind, size_t errorOffset,
+                              const std::string& rawMetadata, const JsonString& item)
+        {
+            if (path.empty()) return;
+            JsonStream line;
+            line << R"({"kind":")" << kind << R"(",)"
+                 << R"("quarantined_at":")" << UtcTimestamp() << R"(",)"
+                 << R"("error_offset":)" << errorOffset << ","
+                 << R"("metadata_raw":)" << WrapAsJSONString(rawMetadata) << ","
+                 << R"("item":)" << item << "}\n";
+            AppendLine(path, line.str());
+        }
+
+        void AppendDeadLetter(const std::string& path, const char* kind, long status, const std::string& error,
+                              int attempts, const JsonString& item)
+        {
+            if (path.empty()) return;
+            JsonStream line;
+            line << R"({"kind":")" << kind << R"(",)"
+                 << R"("failed_at":")" << UtcTimestamp() << R"(",)"
+                 << R"("status":)" << status << ","
+                 << R"("error":)" << WrapAsJSONString(error) << ","
+                 << R"("attempts":)" << attempts << ","
+                 << R"("item":)" << item << "}\n";
+            AppendLine(path, line.str());
+        }
+    }
+
+} // namespace GlitchSDK
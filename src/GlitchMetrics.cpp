@@ -0,0 +1,413 @@
+#include "GlitchSDK.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+#ifdef _WIN32
+    #include <winsock2.h>
+    #include <ws2tcpip.h>
+    typedef SOCKET SocketHandle;
+    #define GLITCH_INVALID_SOCKET INVALID_SOCKET
+    #define GLITCH_CLOSE_SOCKET closesocket
+    #define GLITCH_POLL WSAPoll
+    #define GLITCH_SEND_FLAGS 0
+#else
+    #include <arpa/inet.h>
+    #include <netinet/in.h>
+    #include <poll.h>
+    #include <sys/socket.h>
+    #include <sys/time.h>
+    #include <unistd.h>
+    typedef int SocketHandle;
+    #define GLITCH_INVALID_SOCKET (-1)
+    #define GLITCH_CLOSE_SOCKET close
+    #define GLITCH_POLL poll
+    // A scraper that hangs up mid-response must not raise SIGPIPE in the host process.
+    // Linux takes a send() flag; Apple has SO_NOSIGPIPE on the socket instead (see Serve).
+    #ifdef MSG_NOSIGNAL
+        #define GLITCH_SEND_FLAGS MSG_NOSIGNAL
+    #else
+        #define GLITCH_SEND_FLAGS 0
+    #endif
+#endif
+
+namespace GlitchSDK
+{
+    // --- Histograms ---
+
+    const double LatencyBucketBounds[LatencyHistogram::BucketCount - 1] = {
+        0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1.0, 2.5, 5.0, 10.0
+    };
+
+    namespace Internal
+    {
+        void HistogramCounters::Observe(double seconds)
+        {
+            const size_t bounds = LatencyHistogram::BucketCount - 1;
+            size_t bucket = size_t(std::lower_bound(LatencyBucketBounds, LatencyBucketBounds + bounds, seconds) - LatencyBucketBounds);
+            Buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+            SumMicros.fetch_add(uint64_t(std::max(seconds, 0.0) * 1e6), std::memory_order_relaxed);
+        }
+
+        void HistogramCounters::Load(LatencyHistogram& histogram) const
+        {
+            // Count is the buckets' total, so a scrape racing Observe still gets a consistent histogram
+            histogram.Count = 0;
+            for (size_t i = 0; i < LatencyHistogram::BucketCount; ++i) {
+                histogram.Buckets[i] = Buckets[i].load(std::memory_order_relaxed);
+                histogram.Count += histogram.Buckets[i];
+            }
+            histogram.SumSeconds = double(SumMicros.load(std::memory_order_relaxed)) / 1e6;
+        }
+    }
+
+    // --- OpenMetrics text format ---
+
+    namespace
+    {
+        struct CounterFamily
+        {
+            const char* Name;
+            const char* Help;
+            uint64_t MetricsSnapshot::*Value;
+        };
+
+        const CounterFamily kCounters[] = {
+            { "glitch_validate_cache_hits", "ValidateInstall calls served from the TTL cache", &MetricsSnapshot::ValidateCacheHits },
+            { "glitch_validate_cache_misses", "ValidateInstall calls that sent a request", &MetricsSnapshot::ValidateCacheMisses },
+            { "glitch_validate_coalesced", "ValidateInstall calls that joined an in-flight request", &MetricsSnapshot::ValidateCoalesced },
+            { "glitch_offline_license_accepted", "Startups served from a verified offline token", &MetricsSnapshot::OfflineLicenseAccepted },
+            { "glitch_offline_license_rejected", "Offline tokens missing, expired or with a bad signature", &MetricsSnapshot::OfflineLicenseRejected },
+            { "glitch_wishlist_calls_queued", "QueueWishlistToggle and QueueWishlistScore calls", &MetricsSnapshot::WishlistCallsQueued },
+            { "glitch_wishlist_requests_sent", "Wishlist requests sent after coalescing", &MetricsSnapshot::WishlistRequestsSent },
+            { "glitch_saves_uploaded", "SaveSyncWorker uploads accepted by the server", &MetricsSnapshot::SavesUploaded },
+            { "glitch_saves_superseded", "Dirty saves replaced before they were sent", &MetricsSnapshot::SavesSuperseded },
+            { "glitch_save_conflicts", "Save uploads rejected as conflicts", &MetricsSnapshot::SaveConflicts },
+            { "glitch_saves_rejected", "SaveSyncWorker uploads refused with a non-retryable 4xx", &MetricsSnapshot::SavesRejected },
+            { "glitch_save_parts_sent", "Chunked upload parts acknowledged", &MetricsSnapshot::SavePartsSent },
+            { "glitch_save_part_retries", "Chunked upload parts sent more than once", &MetricsSnapshot::SavePartRetries },
+            { "glitch_events_queued", "Client::QueueEvent calls accepted", &MetricsSnapshot::EventsQueued },
+            { "glitch_events_dropped", "Events dropped because the queue was full", &MetricsSnapshot::EventsDropped },
+            { "glitch_event_batches_sent", "Bulk event requests sent by Client", &MetricsSnapshot::EventBatchesSent },
+            { "glitch_events_accepted", "Events the server confirmed", &MetricsSnapshot::EventsAccepted },
+            { "glitch_events_retried", "Events queued again after a retryable failure", &MetricsSnapshot::EventsRetried },
+            { "glitch_events_dead_lettered", "Events rejected or out of attempts", &MetricsSnapshot::EventsDeadLettered },
+            { "glitch_purchases_dead_lettered", "Purchases refused or out of attempts", &MetricsSnapshot::PurchasesDeadLettered },
+            { "glitch_items_spilled", "Events and purchases written to the spool at shutdown", &MetricsSnapshot::ItemsSpilled },
+            { "glitch_items_replayed", "Spooled items queued again by a new Client", &MetricsSnapshot::ItemsReplayed },
+            { "glitch_metadata_wrapped", "Invalid MetadataJSON sent as a string", &MetricsSnapshot::MetadataWrapped },
+            { "glitch_metadata_quarantined", "Items with invalid MetadataJSON quarantined", &MetricsSnapshot::MetadataQuarantined },
+            { "glitch_metadata_rejected", "Items with invalid MetadataJSON refused", &MetricsSnapshot::MetadataRejected },
+            { "glitch_request_timeouts", "Requests that hit their total, deadline or low-speed limit", &MetricsSnapshot::RequestTimeouts },
+            { "glitch_connect_timeouts", "Requests that could not connect in time", &MetricsSnapshot::ConnectTimeouts },
+            { "glitch_requests_cancelled", "Requests aborted through a CancellationToken", &MetricsSnapshot::RequestsCancelled },
+        };
+
+        struct MemoryFamily
+        {
+            const char* Subsystem;
+            uint64_t MetricsSnapshot::*Bytes;
+            uint64_t MetricsSnapshot::*Allocations;
+        };
+
+        const MemoryFamily kMemory[] = {
+            { "queues", &MetricsSnapshot::QueueBytes, &MetricsSnapshot::QueueAllocations },
+            { "serialization", &MetricsSnapshot::SerializationBytes, &MetricsSnapshot::SerializationAllocations },
+            { "transport", &MetricsSnapshot::TransportBytes, &MetricsSnapshot::TransportAllocations },
+            { "saves", &MetricsSnapshot::SaveBytes, &MetricsSnapshot::SaveAllocations },
+        };
+
+        const char* const kEndpointNames[size_t(Endpoint::Count)] = {
+            "installs", "validate", "purchases", "events", "wishlist", "saves"
+        };
+
+        void AppendNumber(std::string& out, double value)
+        {
+            char buffer[32];
+            snprintf(buffer, sizeof(buffer), "%.15g", value);
+            out += buffer;
+        }
+
+        const char* const kPhaseNames[size_t(RequestPhase::Count)] = {
+            "dns", "connect", "tls", "server", "download"
+        };
+
+        // labels is the preformatted label list without braces, e.g. endpoint="events"
+        void AppendHistogram(std::string& out, const char* name, const std::string& labels,
+                             const LatencyHistogram& histogram)
+        {
+            uint64_t cumulative = 0;
+            for (size_t i = 0; i < LatencyHistogram::BucketCount; ++i) {
+                cumulative += histogram.Buckets[i];
+                out += name;
+                out += "_bucket{";
+                out += labels;
+                out += ",le=\"";
+                if (i + 1 < LatencyHistogram::BucketCount) AppendNumber(out, LatencyBucketBounds[i]);
+                else out += "+Inf";
+                out += "\"} ";
+                out += std::to_string(cumulative);
+                out += '\n';
+            }
+            out += name;
+            out += "_count{";
+            out += labels;
+            out += "} ";
+            out += std::to_string(histogram.Count);
+            out += '\n';
+            out += name;
+            out += "_sum{";
+            out += labels;
+            out += "} ";
+            AppendNumber(out, histogram.SumSeconds);
+            out += '\n';
+        }
+    }
+
+    std::string RenderOpenMetrics(const MetricsSnapshot& metrics)
+    {
+        std::string out;
+        out.reserve(8 * 1024);
+        for (const CounterFamily& family : kCounters) {
+            out += "# TYPE ";
+            out += family.Name;
+            out += " counter\n# HELP ";
+            out += family.Name;
+            out += ' ';
+            out += family.Help;
+            out += '\n';
+            out += family.Name;
+            out += "_total ";
+            out += std::to_string(metrics.*family.Value);
+            out += '\n';
+        }
+
+        out += "# TYPE glitch_memory_bytes gauge\n# HELP glitch_memory_bytes Heap currently allocated per subsystem\n";
+        for (const MemoryFamily& family : kMemory) {
+            out += "glitch_memory_bytes{subsystem=\"";
+            out += family.Subsystem;
+            out += "\"} ";
+            out += std::to_string(metrics.*family.Bytes);
+            out += '\n';
+        }
+        out += "# TYPE glitch_memory_allocations counter\n# HELP glitch_memory_allocations Heap allocations per subsystem\n";
+        for (const MemoryFamily& family : kMemory) {
+            out += "glitch_memory_allocations_total{subsystem=\"";
+            out += family.Subsystem;
+            out += "\"} ";
+            out += std::to_string(metrics.*family.Allocations);
+            out += '\n';
+        }
+
+        out += "# TYPE glitch_request_duration_seconds histogram\n"
+               "# HELP glitch_request_duration_seconds Time spent in the transport per request\n"
+               "# UNIT glitch_request_duration_seconds seconds\n";
+        for (size_t i = 0; i < size_t(Endpoint::Count); ++i) {
+            AppendHistogram(out, "glitch_request_duration_seconds", std::string("endpoint=\"") + kEndpointNames[i] + '"',
+                            metrics.RequestLatency[i]);
+        }
+
+        out += "# TYPE glitch_request_phase_seconds histogram\n"
+               "# HELP glitch_request_phase_seconds Time per connection phase, for requests that reached it\n"
+               "# UNIT glitch_request_phase_seconds seconds\n";
+        for (size_t i = 0; i < size_t(Endpoint::Count); ++i) {
+            for (size_t phase = 0; phase < size_t(RequestPhase::Count); ++phase) {
+                std::string labels = std::string("endpoint=\"") + kEndpointNames[i] + "\",phase=\"" + kPhaseNames[phase] + '"';
+                AppendHistogram(out, "glitch_request_phase_seconds", labels, metrics.RequestPhases[i][phase]);
+            }
+        }
+
+        out += "# EOF\n";
+        return out;
+    }
+
+    // --- Exporter ---
+
+    struct MetricsExporter::State
+    {
+        MetricsExporterConfig Config;
+        SocketHandle Listener = GLITCH_INVALID_SOCKET;
+        int Port = 0;
+        std::atomic<bool> Stop;
+        std::thread Thread;
+
+        State() : Stop(false) {}
+
+        bool OpenListener()
+        {
+#ifdef _WIN32
+            WSADATA wsa;
+            if (WSAStartup(MAKEWORD(2, 2), &wsa) != 0) return false;
+#endif
+            sockaddr_in address;
+            memset(&address, 0, sizeof(address));
+            address.sin_family = AF_INET;
+            address.sin_port = htons((unsigned short)Config.Port);
+            if (inet_pton(AF_INET, Config.BindAddress.c_str(), &address.sin_addr) != 1) return false;
+
+            Listener = socket(AF_INET, SOCK_STREAM, 0);
+            if (Listener == GLITCH_INVALID_SOCKET) return false;
+            int reuse = 1;
+            setsockopt(Listener, SOL_SOCKET, SO_REUSEADDR, (const char*)&reuse, sizeof(reuse));
+            socklen_t length = sizeof(address);
+            if (bind(Listener, (const sockaddr*)&address, sizeof(address)) != 0 || listen(Listener, 16) != 0 ||
+                getsockname(Listener, (sockaddr*)&address, &length) != 0) {
+                GLITCH_CLOSE_SOCKET(Listener);
+                Listener = GLITCH_INVALID_SOCKET;
+                return false;
+            }
+            Port = ntohs(address.sin_port);
+            return true;
+        }
+
+        void CloseListener()
+        {
+            if (Listener == GLITCH_INVALID_SOCKET) return;
+            GLITCH_CLOSE_SOCKET(Listener);
+            Listener = GLITCH_INVALID_SOCKET;
+#ifdef _WIN32
+            WSACleanup();
+#endif
+        }
+
+        // One request per connection; a client that has not sent its request within a
+        // second is dropped, however slowly it trickles bytes in
+        void Serve(SocketHandle client)
+        {
+#ifdef _WIN32
+            DWORD timeout = 1000;
+#else
+            timeval timeout;
+            timeout.tv_sec = 1;
+            timeout.tv_usec = 0;
+#endif
+            setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, (const char*)&timeout, sizeof(timeout));
+            setsockopt(client, SOL_SOCKET, SO_SNDTIMEO, (const char*)&timeout, sizeof(timeout));
+#ifdef SO_NOSIGPIPE
+            int noSigPipe = 1;
+            setsockopt(client, SOL_SOCKET, SO_NOSIGPIPE, &noSigPipe, sizeof(noSigPipe));
+#endif
+
+            // SO_RCVTIMEO bounds each recv, not the whole read, so poll against one deadline
+            auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+            std::string request;
+            char buffer[1024];
+            while (request.find("\r\n\r\n") == std::string::npos && request.size() < 8192) {
+                auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+                if (remaining.count() <= 0) return;
+                pollfd entry;
+                entry.fd = client;
+                entry.events = POLLIN;
+                entry.revents = 0;
+                if (GLITCH_POLL(&entry, 1, (int)remaining.count()) <= 0) return;
+                int received = (int)recv(client, buffer, sizeof(buffer), 0);
+                if (received <= 0) return;
+                request.append(buffer, size_t(received));
+            }
+
+            const char* status = "200 OK";
+            std::string body;
+            if (request.compare(0, 4, "GET ") != 0) {
+                status = "405 Method Not Allowed";
+            } else if (request.compare(4, 9, "/metrics ") != 0 && request.compare(4, 9, "/metrics?") != 0 &&
+                       request.compare(4, 2, "/ ") != 0) {
+                status = "404 Not Found";
+            } else {
+                body = RenderOpenMetrics(GetMetrics());
+            }
+
+            std::string response = "HTTP/1.1 ";
+            response += status;
+            response += "\r\nContent-Type: application/openmetrics-text; version=1.0.0; charset=utf-8\r\nContent-Length: ";
+            response += std::to_string(body.size());
+            response += "\r\nConnection: close\r\n\r\n";
+            response += body;
+            size_t sent = 0;
+            while (sent < response.size()) {
+                int written = (int)send(client, response.data() + sent, (int)(response.size() - sent), GLITCH_SEND_FLAGS);
+                if (written <= 0) return; // Failed or hung up: drop the client
+                sent += size_t(written);
+            }
+        }
+
+        // Written beside the target and renamed so a collector never reads half a file
+        void WriteFile()
+        {
+            std::string text = RenderOpenMetrics(GetMetrics());
+            std::string temporary = Config.FilePath + ".tmp";
+            std::FILE* file = std::fopen(temporary.c_str(), "wb");
+            if (!file) return;
+            bool written = std::fwrite(text.data(), 1, text.size(), file) == text.size();
+            if (std::fclose(file) != 0 || !written) {
+                std::remove(temporary.c_str());
+                return;
+            }
+            if (!Internal::RenameReplacing(temporary, Config.FilePath)) std::remove(temporary.c_str());
+        }
+
+        void Run()
+        {
+            auto interval = std::chrono::milliseconds(std::max(Config.FileIntervalMs, 100));
+            auto nextWrite = std::chrono::steady_clock::now();
+            while (!Stop.load(std::memory_order_relaxed)) {
+                auto now = std::chrono::steady_clock::now();
+                if (!Config.FilePath.empty() && now >= nextWrite) {
+                    WriteFile();
+                    nextWrite = now + interval;
+                }
+
+                // Wake at least every 100 ms to notice Stop
+                int wait = 100;
+                if (!Config.FilePath.empty()) {
+                    auto untilWrite = std::chrono::duration_cast<std::chrono::milliseconds>(nextWrite - now).count();
+                    wait = int(std::max<long long>(0, std::min<long long>(wait, untilWrite)));
+                }
+                if (Listener == GLITCH_INVALID_SOCKET) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(wait));
+                    continue;
+                }
+                pollfd entry;
+                entry.fd = Listener;
+                entry.events = POLLIN;
+                entry.revents = 0;
+                if (GLITCH_POLL(&entry, 1, wait) <= 0 || !(entry.revents & POLLIN)) continue;
+                SocketHandle client = accept(Listener, nullptr, nullptr);
+                if (client == GLITCH_INVALID_SOCKET) continue;
+                Serve(client);
+                GLITCH_CLOSE_SOCKET(client);
+            }
+            if (!Config.FilePath.empty()) WriteFile();
+        }
+    };
+
+    MetricsExporter::MetricsExporter(const MetricsExporterConfig& config) : Impl(new State())
+    {
+        Impl->Config = config;
+        if (config.Listen) Impl->OpenListener();
+        if (Impl->Listener != GLITCH_INVALID_SOCKET || !config.FilePath.empty()) {
+            State* state = Impl.get();
+            Impl->Thread = std::thread([state]() { state->Run(); });
+        }
+    }
+
+    MetricsExporter::~MetricsExporter()
+    {
+        Impl->Stop.store(true, std::memory_order_relaxed);
+        if (Impl->Thread.joinable()) Impl->Thread.join();
+        Impl->CloseListener();
+    }
+
+    bool MetricsExporter::IsListening() const
+    {
+        return Impl->Listener != GLITCH_INVALID_SOCKET;
+    }
+
+    int MetricsExporter::GetPort() const
+    {
+        return IsListening() ? Impl->Port : 0;
+    }
+
+} // namespace GlitchSDK
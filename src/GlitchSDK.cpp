@@ -1,8 +1,23 @@
 #include "GlitchSDK.h"
 #include <curl/curl.h>
+#include <openssl/evp.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <future>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <sstream>
 #include <iostream>
+#include <list>
+#include <thread>
+#include <unordered_map>
 
 // Platform-specific includes for fingerprinting
 #ifdef _WIN32
@@ -14,7 +29,6 @@
     #include <sys/sysctl.h>
 #elif __linux__
     #include <sys/utsname.h>
-    #include <fstream>
 #endif
 
 namespace GlitchSDK 
@@ -22,6 +36,12 @@ namespace GlitchSDK
     // Internal helper implementations
     namespace Internal 
     {
+        MetricCounters& Counters()
+        {
+            static MetricCounters counters;
+            return counters;
+        }
+
         size_t WriteCallback(char* ptr, size_t size, size_t nmemb, void* userdata) 
         {
             ((std::string*)userdata)->append((char*)ptr, size * nmemb);
@@ -44,6 +64,26 @@ namespace GlitchSDK
             return escaped;
         }
 
+        void AppendEscapedJSON(JsonString& out, const std::string& input)
+        {
+            size_t start = 0;
+            for (size_t i = 0; i < input.size(); ++i) {
+                const char* replacement;
+                switch (input[i]) {
+                    case '"': replacement = "\\\""; break;
+                    case '\\': replacement = "\\\\"; break;
+                    case '\n': replacement = "\\n"; break;
+                    case '\r': replacement = "\\r"; break;
+                    case '\t': replacement = "\\t"; break;
+                    default: continue;
+                }
+                out.append(input.data() + start, i - start);
+                out += replacement;
+                start = i + 1;
+            }
+            out.append(input.data() + start, input.size() - start);
+        }
+
         std::string GetSystemInfo(const std::string& key) 
         {
             #ifdef _WIN32
@@ -94,130 +134,696 @@ namespace GlitchSDK
             
             return "unknown";
         }
+
+        bool RenameReplacing(const std::string& from, const std::string& to)
+        {
+            #ifdef _WIN32
+                return MoveFileExA(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+            #else
+                return std::rename(from.c_str(), to.c_str()) == 0;
+            #endif
+        }
+
+        size_t Base64EncodeTo(const unsigned char* data, size_t size, char* out)
+        {
+            static const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+            char* start = out;
+            size_t i = 0;
+            for (; i + 2 < size; i += 3) {
+                uint32_t n = (uint32_t(data[i]) << 16) | (uint32_t(data[i + 1]) << 8) | data[i + 2];
+                *out++ = alphabet[(n >> 18) & 63];
+                *out++ = alphabet[(n >> 12) & 63];
+                *out++ = alphabet[(n >> 6) & 63];
+                *out++ = alphabet[n & 63];
+            }
+            if (i < size) {
+                uint32_t n = uint32_t(data[i]) << 16;
+                if (i + 1 < size) n |= uint32_t(data[i + 1]) << 8;
+                *out++ = alphabet[(n >> 18) & 63];
+                *out++ = alphabet[(n >> 12) & 63];
+                *out++ = (i + 1 < size) ? alphabet[(n >> 6) & 63] : '=';
+                *out++ = '=';
+            }
+            return size_t(out - start);
+        }
+
+        std::string Base64Encode(const unsigned char* data, size_t size)
+        {
+            std::string out((size + 2) / 3 * 4, '\0');
+            if (!out.empty()) Base64EncodeTo(data, size, &out[0]);
+            return out;
+        }
+
+        bool Base64Decode(const std::string& input, std::string& output)
+        {
+            output.clear();
+            output.reserve(input.size() / 4 * 3);
+            uint32_t buffer = 0;
+            int bits = 0;
+            for (char c : input) {
+                int v;
+                if (c >= 'A' && c <= 'Z') v = c - 'A';
+                else if (c >= 'a' && c <= 'z') v = c - 'a' + 26;
+                else if (c >= '0' && c <= '9') v = c - '0' + 52;
+                else if (c == '+' || c == '-') v = 62;
+                else if (c == '/' || c == '_') v = 63;
+                else if (c == '=') break;
+                else return false;
+                buffer = (buffer << 6) | uint32_t(v);
+                bits += 6;
+                if (bits >= 8) {
+                    bits -= 8;
+                    output += char((buffer >> bits) & 0xFF);
+                }
+            }
+            return true;
+        }
+
+        // Position just past the ':' following "key", or npos
+        static size_t FindJSONValue(const std::string& json, const std::string& key)
+        {
+            std::string quoted = "\"" + key + "\"";
+            size_t pos = 0;
+            while ((pos = json.find(quoted, pos)) != std::string::npos) {
+                pos += quoted.size();
+                size_t colon = json.find_first_not_of(" \t\r\n", pos);
+                if (colon != std::string::npos && json[colon] == ':') {
+                    size_t value = json.find_first_not_of(" \t\r\n", colon + 1);
+                    return value;
+                }
+            }
+            return std::string::npos;
+        }
+
+        bool ExtractJSONString(const std::string& json, const std::string& key, std::string& value)
+        {
+            size_t pos = FindJSONValue(json, key);
+            if (pos == std::string::npos || json[pos] != '"') return false;
+            value.clear();
+            for (size_t i = pos + 1; i < json.size(); ++i) {
+                char c = json[i];
+                if (c == '"') return true;
+                if (c == '\\' && i + 1 < json.size()) {
+                    char e = json[++i];
+                    switch (e) {
+                        case 'n': value += '\n'; break;
+                        case 'r': value += '\r'; break;
+                        case 't': value += '\t'; break;
+                        case 'b': value += '\b'; break;
+                        case 'f': value += '\f'; break;
+                        default: value += e; break;
+                    }
+                } else {
+                    value += c;
+                }
+            }
+            return false;
+        }
+
+        bool ExtractJSONNumber(const std::string& json, const std::string& key, double& value)
+        {
+            size_t pos = FindJSONValue(json, key);
+            if (pos == std::string::npos) return false;
+            const char* start = json.c_str() + pos;
+            char* end = nullptr;
+            value = std::strtod(start, &end);
+            return end != start;
+        }
+
+        // Position just past the string, object, array or scalar starting at pos, or npos
+        static size_t SkipJSONValue(const std::string& json, size_t pos)
+        {
+            int depth = 0;
+            bool inString = false;
+            for (size_t i = pos; i < json.size(); ++i) {
+                char c = json[i];
+                if (inString) {
+                    if (c == '\\') ++i;
+                    else if (c == '"') {
+                        inString = false;
+                        if (depth == 0) return i + 1;
+                    }
+                    continue;
+                }
+                if (c == '"') {
+                    inString = true;
+                } else if (c == '{' || c == '[') {
+                    depth++;
+                } else if (c == '}' || c == ']') {
+                    if (depth == 0) return i;
+                    if (--depth == 0) return i + 1;
+                } else if (c == ',' && depth == 0) {
+                    return i;
+                }
+            }
+            return depth == 0 && !inString ? json.size() : std::string::npos;
+        }
+
+        bool ExtractJSONField(const std::string& json, const std::string& key, std::string& value)
+        {
+            static const char* const kSpace = " \t\r\n";
+            size_t pos = json.find_first_not_of(kSpace);
+            if (pos == std::string::npos || json[pos] != '{') return false;
+            for (;;) {
+                pos = json.find_first_not_of(kSpace, pos + 1);
+                if (pos == std::string::npos || json[pos] != '"') return false;
+                size_t keyEnd = SkipJSONValue(json, pos);
+                if (keyEnd == std::string::npos) return false;
+                bool match = json.compare(pos + 1, keyEnd - pos - 2, key) == 0;
+
+                size_t colon = json.find_first_not_of(kSpace, keyEnd);
+                if (colon == std::string::npos || json[colon] != ':') return false;
+                size_t start = json.find_first_not_of(kSpace, colon + 1);
+                if (start == std::string::npos) return false;
+                size_t end = SkipJSONValue(json, start);
+                if (end == std::string::npos || end == start) return false;
+                if (match) {
+                    value = json.substr(start, json.find_last_not_of(kSpace, end - 1) + 1 - start);
+                    return true;
+                }
+
+                pos = json.find_first_not_of(kSpace, end);
+                if (pos == std::string::npos || json[pos] != ',') return false;
+            }
+        }
+
+        bool ExtractJSONArray(const std::string& json, const std::string& key, std::vector<std::string>& elements)
+        {
+            size_t pos = FindJSONValue(json, key);
+            if (pos == std::string::npos || json[pos] != '[') return false;
+            elements.clear();
+
+            // Split on top-level commas, skipping over nested values and strings
+            int depth = 0;
+            bool inString = false;
+            size_t start = pos + 1;
+            for (size_t i = pos + 1; i < json.size(); ++i) {
+                char c = json[i];
+                if (inString) {
+                    if (c == '\\') ++i;
+                    else if (c == '"') inString = false;
+                    continue;
+                }
+                if (c == '"') {
+                    inString = true;
+                } else if (c == '{' || c == '[') {
+                    depth++;
+                } else if ((c == '}' || c == ']') && depth > 0) {
+                    depth--;
+                } else if ((c == ',' || c == ']') && depth == 0) {
+                    size_t first = json.find_first_not_of(" \t\r\n", start);
+                    if (first < i) elements.push_back(json.substr(first, json.find_last_not_of(" \t\r\n", i - 1) + 1 - first));
+                    if (c == ']') return true;
+                    start = i + 1;
+                }
+            }
+            return false;
+        }
     }
 
-    std::string CreateInstallRecord(const std::string& authToken, const std::string& titleId, 
-                                  const std::string& userInstallId, const std::string& platform)
+    const char* const Internal::ApiBaseUrl = "https://api.glitch.fun/api";
+
+    // --- Memory ---
+
+    namespace
     {
-        CURL* curl = curl_easy_init();
-        if (!curl) return "Failed to init curl";
+        class DefaultAllocator : public IAllocator
+        {
+        public:
+            void* Allocate(size_t size, size_t, MemoryTag) override { return ::operator new(size, std::nothrow); }
+            void Deallocate(void* pointer, size_t, MemoryTag) override { ::operator delete(pointer); }
+        };
 
-        std::string url = "https://api.glitch.fun/api/titles/" + titleId + "/installs";
+        std::atomic<IAllocator*> g_allocator(nullptr);
 
-        // Simple JSON payload for basic install
-        std::string jsonBody = R"({"user_install_id":")" + userInstallId + 
-                             R"(","platform":")" + platform + R"("})";
+        // libcurl only passes the pointer to free/realloc, so each block carries its size
+        // in a header that also keeps the returned pointer max-aligned
+        IAllocator* g_curlAllocator = nullptr;
+        const size_t kCurlHeader = 16;
 
-        struct curl_slist *headers = NULL;
-        headers = curl_slist_append(headers, "Content-Type: application/json");
-        std::string authHeader = "Authorization: Bearer " + authToken;
-        headers = curl_slist_append(headers, authHeader.c_str());
+        void* CurlMalloc(size_t size)
+        {
+            char* block = (char*)Internal::Allocate(g_curlAllocator, size + kCurlHeader, kCurlHeader, MemoryTag::Transport);
+            if (!block) return nullptr;
+            *(size_t*)block = size;
+            return block + kCurlHeader;
+        }
 
-        curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-        curl_easy_setopt(curl, CURLOPT_POST, 1L);
-        curl_easy_setopt(curl, CURLOPT_POSTFIELDS, jsonBody.c_str());
+        void CurlFree(void* pointer)
+        {
+            if (!pointer) return;
+            char* block = (char*)pointer - kCurlHeader;
+            Internal::Deallocate(g_curlAllocator, block, *(size_t*)block + kCurlHeader, MemoryTag::Transport);
+        }
 
-        std::string responseString;
-        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, Internal::WriteCallback);
-        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &responseString);
+        void* CurlRealloc(void* pointer, size_t size)
+        {
+            void* resized = CurlMalloc(size);
+            if (resized && pointer) {
+                memcpy(resized, pointer, std::min(size, *(size_t*)((char*)pointer - kCurlHeader)));
+                CurlFree(pointer);
+            }
+            return resized;
+        }
 
-        CURLcode res = curl_easy_perform(curl);
-        if (res != CURLE_OK) {
-            responseString = "CURL error: " + std::string(curl_easy_strerror(res));
+        char* CurlStrdup(const char* text)
+        {
+            size_t size = strlen(text) + 1;
+            char* copy = (char*)CurlMalloc(size);
+            if (copy) memcpy(copy, text, size);
+            return copy;
         }
 
-        curl_easy_cleanup(curl);
-        curl_slist_free_all(headers);
-        return responseString;
+        void* CurlCalloc(size_t count, size_t size)
+        {
+            void* pointer = CurlMalloc(count * size);
+            if (pointer) memset(pointer, 0, count * size);
+            return pointer;
+        }
     }
 
-    std::string CreateInstallRecordWithFingerprint(const std::string& authToken, const std::string& titleId,
-                                                 const std::string& userInstallId, const std::string& platform,
-                                                 const FingerprintComponents& fingerprint,
-                                                 const std::string& gameVersion,
-                                                 const std::string& referralSource)
+    void SetAllocator(IAllocator* allocator)
     {
-        CURL* curl = curl_easy_init();
-        if (!curl) return "Failed to init curl";
+        static std::once_flag curlInit;
+        g_allocator.store(allocator);
+        if (!allocator) return;
+
+        // Only effective before libcurl's first use; afterwards curl stays on malloc
+        std::call_once(curlInit, [allocator]() {
+            g_curlAllocator = allocator;
+            curl_global_init_mem(CURL_GLOBAL_DEFAULT, CurlMalloc, CurlFree, CurlRealloc, CurlStrdup, CurlCalloc);
+        });
+    }
 
-        std::string url = "https://api.glitch.fun/api/titles/" + titleId + "/installs";
+    IAllocator* GetAllocator()
+    {
+        static DefaultAllocator defaultAllocator;
+        IAllocator* allocator = g_allocator.load();
+        return allocator ? allocator : &defaultAllocator;
+    }
+
+    namespace Internal
+    {
+        void* Allocate(IAllocator* allocator, size_t size, size_t alignment, MemoryTag tag)
+        {
+            void* pointer = allocator->Allocate(size, alignment, tag);
+            if (pointer) {
+                Counters().MemoryBytes[size_t(tag)].fetch_add(size, std::memory_order_relaxed);
+                Counters().MemoryAllocations[size_t(tag)].fetch_add(1, std::memory_order_relaxed);
+            }
+            return pointer;
+        }
+
+        void Deallocate(IAllocator* allocator, void* pointer, size_t size, MemoryTag tag)
+        {
+            Counters().MemoryBytes[size_t(tag)].fetch_sub(size, std::memory_order_relaxed);
+            allocator->Deallocate(pointer, size, tag);
+        }
+    }
+
+    // --- Title context ---
+
+    TitleContext::TitleContext(const std::string& bearerToken, const std::string& titleId)
+        : TitleId(titleId)
+    {
+        std::string base = std::string(Internal::ApiBaseUrl) + "/titles/" + titleId;
+        Installs = base + "/installs";
+        Purchases = base + "/purchases";
+        Events = base + "/events";
+        EventsBulk = base + "/events/bulk";
+        Wishlist = base + "/wishlist";
+        WishlistScore = base + "/wishlist/score";
+
+        Authorization = "Authorization: Bearer " + bearerToken;
+        JsonHeaderList = curl_slist_append(JsonHeaderList, "Content-Type: application/json");
+        JsonHeaderList = curl_slist_append(JsonHeaderList, Authorization.c_str());
+        AuthHeaderList = curl_slist_append(AuthHeaderList, Authorization.c_str());
+    }
+
+    TitleContext::~TitleContext()
+    {
+        curl_slist_free_all(JsonHeaderList);
+        curl_slist_free_all(AuthHeaderList);
+    }
+
+    namespace
+    {
+        // Wishlist calls pass per-user JWTs that rotate, so the context cache is an LRU
+        // rather than a map that grows for the life of the process. Evicted contexts stay
+        // alive for as long as a Client or worker still holds them.
+        const size_t kMaxTitleContexts = 64;
+
+        struct TitleContextCache
+        {
+            typedef std::list<std::pair<std::string, std::shared_ptr<const TitleContext> > > Entries;
+
+            std::mutex Mutex;
+            Entries Recent;                                     // Most recently used first
+            std::unordered_map<std::string, Entries::iterator> Index;
+        };
+    }
+
+    std::shared_ptr<const TitleContext> TitleContext::Get(const std::string& bearerToken, const std::string& titleId)
+    {
+        static TitleContextCache cache;
+
+        std::string key = bearerToken + '\n' + titleId;
+        std::lock_guard<std::mutex> lock(cache.Mutex);
+        auto found = cache.Index.find(key);
+        if (found != cache.Index.end()) {
+            cache.Recent.splice(cache.Recent.begin(), cache.Recent, found->second);
+            return found->second->second;
+        }
+
+        std::shared_ptr<const TitleContext> context = std::make_shared<TitleContext>(bearerToken, titleId);
+        cache.Recent.emplace_front(key, context);
+        cache.Index[std::move(key)] = cache.Recent.begin();
+        if (cache.Recent.size() > kMaxTitleContexts) {
+            cache.Index.erase(cache.Recent.back().first);
+            cache.Recent.pop_back();
+        }
+        return context;
+    }
+
+    std::string TitleContext::InstallUrl(const std::string& installId, const char* suffix) const
+    {
+        std::string url;
+        url.reserve(Installs.size() + 1 + installId.size() + strlen(suffix));
+        url += Installs;
+        url += '/';
+        url += installId;
+        url += suffix;
+        return url;
+    }
+
+    Endpoint TitleContext::EndpointFor(const std::string& url) const
+    {
+        if (url == Events || url == EventsBulk) return Endpoint::Events;
+        if (url == Purchases) return Endpoint::Purchases;
+        if (url == Wishlist || url == WishlistScore) return Endpoint::Wishlist;
+        if (url.compare(0, Installs.size(), Installs) != 0 || url.size() == Installs.size()) return Endpoint::Installs;
+        if (url.find("/saves", Installs.size()) != std::string::npos) return Endpoint::Saves;
+        static const char kValidate[] = "/validate";
+        size_t suffix = sizeof(kValidate) - 1;
+        if (url.size() > suffix && url.compare(url.size() - suffix, suffix, kValidate) == 0) return Endpoint::Validate;
+        return Endpoint::Installs;
+    }
+
+    std::string TitleContext::Send(const std::string& url, const char* body, size_t bodySize, long* status) const
+    {
+        HttpRequest request;
+        request.Url = url;
+        if (body) {
+            request.Method = "POST";
+            request.Headers = JsonHeaderList;
+            request.SetBody(body, bodySize);
+        } else {
+            request.Headers = AuthHeaderList;
+        }
+
+        HttpResponse response = Internal::SendRequest(request, EndpointFor(url));
+        if (status) *status = response.StatusCode;
+        return response.Error.empty() ? response.Body : response.Error;
+    }
+
+    std::string TitleContext::Send(const std::string& url, BodySegments& body, long* status) const
+    {
+        HttpRequest request;
+        request.Method = "POST";
+        request.Url = url;
+        request.Headers = JsonHeaderList;
+        request.SetBody(body);
+
+        HttpResponse response = Internal::SendRequest(request, EndpointFor(url));
+        if (status) *status = response.StatusCode;
+        return response.Error.empty() ? response.Body : response.Error;
+    }
+
+    std::string TitleContext::CreateInstallRecord(const std::string& userInstallId, const std::string& platform) const
+    {
+        // Simple JSON payload for basic install
+        std::string jsonBody = R"({"user_install_id":")" + userInstallId + 
+                             R"(","platform":")" + platform + R"("})";
+        return Send(Installs, &jsonBody);
+    }
+
+    std::string TitleContext::CreateInstallRecordWithFingerprint(const std::string& userInstallId, const std::string& platform,
+                                                                 const FingerprintComponents& fingerprint,
+                                                                 const std::string& gameVersion,
+                                                                 const std::string& referralSource) const
+    {
+        // Only the per-call fields are written here; the fingerprint blob is shared and sent as its own segment
+        Internal::JsonString head;
+        head += R"({"user_install_id":")";
+        Internal::AppendEscapedJSON(head, userInstallId);
+        head += R"(","platform":")";
+        Internal::AppendEscapedJSON(head, platform);
+        head += R"(",)";
 
-        // Build JSON payload with fingerprint data
-        std::stringstream jsonPayload;
-        jsonPayload << R"({)";
-        jsonPayload << R"("user_install_id":")" << Internal::EscapeJSON(userInstallId) << R"(",)";
-        jsonPayload << R"("platform":")" << Internal::EscapeJSON(platform) << R"(",)";
-        
         if (!gameVersion.empty()) {
-            jsonPayload << R"("game_version":")" << Internal::EscapeJSON(gameVersion) << R"(",)";
+            head += R"("game_version":")";
+            Internal::AppendEscapedJSON(head, gameVersion);
+            head += R"(",)";
         }
-        
+
         if (!referralSource.empty()) {
-            jsonPayload << R"("referral_source":")" << Internal::EscapeJSON(referralSource) << R"(",)";
+            head += R"("referral_source":")";
+            Internal::AppendEscapedJSON(head, referralSource);
+            head += R"(",)";
         }
+        head += R"("fingerprint_components":)";
+
+        std::shared_ptr<const Internal::JsonString> components = Internal::CachedFingerprintJSON(fingerprint);
+        BodySegments body;
+        body.Append(head.data(), head.size());
+        body.Append(components->data(), components->size(), components);
+        body.AppendLiteral("}");
+        return Send(Installs, body);
+    }
 
-        // Add fingerprint components
-        jsonPayload << R"("fingerprint_components":)" << FingerprintToJSON(fingerprint);
-        jsonPayload << R"(})";
+    std::string TitleContext::RecordPurchase(const PurchaseData& purchaseData, long* status) const
+    {
+        std::string jsonBody = PurchaseToJSON(purchaseData);
+        return Send(Purchases, &jsonBody, status);
+    }
 
-        std::string jsonBody = jsonPayload.str();
+    std::string TitleContext::ListSaves(const std::string& installId) const
+    {
+        return Send(InstallUrl(installId, "/saves"), nullptr);
+    }
 
-        struct curl_slist *headers = NULL;
-        headers = curl_slist_append(headers, "Content-Type: application/json");
-        std::string authHeader = "Authorization: Bearer " + authToken;
-        headers = curl_slist_append(headers, authHeader.c_str());
+    std::string TitleContext::StoreSave(const std::string& installId, const GameSaveData& saveData, long* status) const
+    {
+        Internal::JsonString jsonBody = Internal::SaveJSON(saveData);
+        return Send(InstallUrl(installId, "/saves"), jsonBody.data(), jsonBody.size(), status);
+    }
 
-        curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-        curl_easy_setopt(curl, CURLOPT_POST, 1L);
-        curl_easy_setopt(curl, CURLOPT_POSTFIELDS, jsonBody.c_str());
+    Internal::JsonString Internal::SaveJSON(const GameSaveData& saveData)
+    {
+        Internal::JsonStream json;
+        json << "{"
+             << R"("slot_index":)" << saveData.SlotIndex << ","
+             << R"("payload":")" << saveData.PayloadBase64 << R"(",)"
+             << R"("checksum":")" << saveData.Checksum << R"(",)"
+             << R"("base_version":)" << saveData.BaseVersion << ","
+             << R"("save_type":")" << saveData.SaveType << R"(",)"
+             << R"("client_timestamp":")" << saveData.ClientTimestamp << R"(")";
+        if(!saveData.Codec.empty()) json << R"(,"codec":")" << Internal::EscapeJSON(saveData.Codec) << R"(")";
+        if(!saveData.MetadataJSON.empty()) json << R"(,"metadata":)" << saveData.MetadataJSON;
+        json << "}";
+        return json.str();
+    }
 
-        std::string responseString;
-        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, Internal::WriteCallback);
-        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &responseString);
+    std::string TitleContext::ResolveSaveConflict(const std::string& installId, const std::string& saveId,
+                                                  const std::string& conflictId, const std::string& choice) const
+    {
+        Internal::JsonStream json;
+        json << "{"
+             << R"("conflict_id":")" << conflictId << R"(",)"
+             << R"("choice":")" << choice << R"(")"
+             << "}";
+
+        Internal::JsonString jsonBody = json.str();
+        return Send(InstallUrl(installId, "/saves/") + saveId + "/resolve", jsonBody.data(), jsonBody.size());
+    }
 
-        CURLcode res = curl_easy_perform(curl);
-        if (res != CURLE_OK) {
-            responseString = "CURL error: " + std::string(curl_easy_strerror(res));
+    namespace Internal
+    {
+        void AppendEventJSON(JsonString& json, const GameEventData& event)
+        {
+            json += R"({"game_install_id":")";
+            json.append(event.GameInstallID.data(), event.GameInstallID.size());
+            json += R"(","step_key":")";
+            AppendEscapedJSON(json, event.StepKey);
+            json += R"(","action_key":")";
+            AppendEscapedJSON(json, event.ActionKey);
+            json += '"';
+            if(!event.MetadataJSON.empty()) {
+                json += R"(,"metadata":)";
+                json.append(event.MetadataJSON.data(), event.MetadataJSON.size());
+            }
+            json += '}';
         }
+    }
 
-        curl_easy_cleanup(curl);
-        curl_slist_free_all(headers);
-        return responseString;
+    namespace
+    {
+        // Serialized size before escaping, for reserving buffers up front
+        size_t EventJSONSize(const GameEventData& event)
+        {
+            return 72 + event.GameInstallID.size() + event.StepKey.size() + event.ActionKey.size() + event.MetadataJSON.size();
+        }
+
+        // Below this many events per range, splitting costs more than it saves
+        const size_t MinEventsPerRange = 4096;
     }
 
-    std::string RecordPurchase(const std::string& authToken, const std::string& titleId, 
-                              const PurchaseData& purchaseData)
+    std::string TitleContext::RecordEvent(const GameEventData& event) const
     {
-        CURL* curl = curl_easy_init();
-        if (!curl) return "Failed to init curl";
+        Internal::JsonString jsonBody;
+        jsonBody.reserve(EventJSONSize(event));
+        Internal::AppendEventJSON(jsonBody, event);
+        return Send(Events, jsonBody.data(), jsonBody.size());
+    }
 
-        std::string url = "https://api.glitch.fun/api/titles/" + titleId + "/purchases";
-        std::string jsonBody = PurchaseToJSON(purchaseData);
+    std::string TitleContext::RecordEventsBulk(const std::vector<GameEventData>& events, long* status) const
+    {
+        HttpResponse response = PostEventsBulk(events);
+        if (status) *status = response.StatusCode;
+        return response.Error.empty() ? response.Body : response.Error;
+    }
 
-        struct curl_slist *headers = NULL;
-        headers = curl_slist_append(headers, "Content-Type: application/json");
-        std::string authHeader = "Authorization: Bearer " + authToken;
-        headers = curl_slist_append(headers, authHeader.c_str());
+    // Kept apart from RecordEventsBulk so SendEventsBulk sees the whole response
+    HttpResponse TitleContext::PostEventsBulk(const std::vector<GameEventData>& events) const
+    {
+        // Events are appended straight into the buffers that get sent. Large batches
+        // are split into contiguous ranges serialized in parallel, and the range
+        // buffers go out as segments of one body rather than being joined.
+        size_t ranges = std::max(size_t(1), std::min(Internal::ExecutorConcurrency(), events.size() / MinEventsPerRange));
+        Internal::TaggedVector<Internal::JsonString, MemoryTag::Serialization> buffers(ranges);
+        auto serialize = [&](size_t range) {
+            size_t begin = events.size() * range / ranges;
+            size_t end = events.size() * (range + 1) / ranges;
+
+            size_t reserve = 16;
+            for (size_t i = begin; i < end; ++i) reserve += EventJSONSize(events[i]);
+
+            Internal::JsonString& json = buffers[range];
+            json.reserve(reserve);
+            json += range == 0 ? R"({"events":[)" : ",";
+            for (size_t i = begin; i < end; ++i) {
+                if (i > begin) json += ',';
+                Internal::AppendEventJSON(json, events[i]);
+            }
+            if (range == ranges - 1) json += "]}";
+        };
 
-        curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-        curl_easy_setopt(curl, CURLOPT_POST, 1L);
-        curl_easy_setopt(curl, CURLOPT_POSTFIELDS, jsonBody.c_str());
+        HttpRequest request;
+        request.Method = "POST";
+        request.Url = EventsBulk;
+        request.Headers = JsonHeaderList;
+        BodySegments body;
+        if (ranges == 1) {
+            serialize(0);
+            request.SetBody(buffers[0].data(), buffers[0].size());
+        } else {
+            Internal::ParallelFor(ranges, ranges, serialize);
+            for (const Internal::JsonString& buffer : buffers) body.Append(buffer.data(), buffer.size());
+            request.SetBody(body);
+        }
+        return Internal::SendRequest(request, Endpoint::Events);
+    }
 
-        std::string responseString;
-        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, Internal::WriteCallback);
-        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &responseString);
+    bool Internal::IsRetryableStatus(long status)
+    {
+        return status == 0 || status == 408 || status == 425 || status == 429 || status >= 500;
+    }
 
-        CURLcode res = curl_easy_perform(curl);
-        if (res != CURLE_OK) {
-            responseString = "CURL error: " + std::string(curl_easy_strerror(res));
+    namespace
+    {
+        EventOutcome ClassifyEventStatus(long status)
+        {
+            if (status >= 200 && status < 300) return EventOutcome::Accepted;
+            if (Internal::IsRetryableStatus(status)) return EventOutcome::Retry;
+            return EventOutcome::Rejected;
         }
+    }
+
+    BulkEventsResult TitleContext::SendEventsBulk(const std::vector<GameEventData>& events) const
+    {
+        BulkEventsResult result;
+        HttpResponse response = PostEventsBulk(events);
+        result.StatusCode = response.StatusCode;
+        result.Response = response.Error.empty() ? response.Body : response.Error;
+        result.RetryAfter = response.RetryAfter;
+        result.Outcomes.assign(events.size(), ClassifyEventStatus(result.StatusCode));
+        result.Statuses.assign(events.size(), result.StatusCode);
+        result.Errors.assign(events.size(), std::string());
+
+        // Per-item statuses only mean something if the batch itself got through
+        std::vector<std::string> items;
+        if (ClassifyEventStatus(result.StatusCode) != EventOutcome::Retry &&
+            Internal::ExtractJSONArray(result.Response, "results", items) && items.size() == events.size()) {
+            for (size_t i = 0; i < items.size(); ++i) {
+                double status = 0;
+                if (Internal::ExtractJSONNumber(items[i], "status", status)) {
+                    result.Statuses[i] = long(status);
+                    result.Outcomes[i] = ClassifyEventStatus(result.Statuses[i]);
+                }
+                Internal::ExtractJSONString(items[i], "error", result.Errors[i]);
+            }
+        }
+
+        for (EventOutcome outcome : result.Outcomes) {
+            if (outcome == EventOutcome::Accepted) result.Accepted++;
+            else if (outcome == EventOutcome::Retry) result.Retryable++;
+            else result.Rejected++;
+        }
+        return result;
+    }
+
+    std::string TitleContext::ToggleWishlist(const std::string& fingerprintId, long* status) const
+    {
+        Internal::JsonStream json;
+        json << "{";
+        if(!fingerprintId.empty()) json << R"("fingerprint_id":")" << fingerprintId << R"(")";
+        json << "}";
+
+        Internal::JsonString jsonBody = json.str();
+        return Send(Wishlist, jsonBody.data(), jsonBody.size(), status);
+    }
+
+    std::string TitleContext::UpdateWishlistScore(int score, long* status) const
+    {
+        Internal::JsonStream json;
+        json << R"({"score":)" << score << "}";
+
+        Internal::JsonString jsonBody = json.str();
+        return Send(WishlistScore, jsonBody.data(), jsonBody.size(), status);
+    }
+
+    // --- 1. Installs & purchases ---
+
+    std::string CreateInstallRecord(const std::string& authToken, const std::string& titleId, 
+                                  const std::string& userInstallId, const std::string& platform)
+    {
+        return TitleContext::Get(authToken, titleId)->CreateInstallRecord(userInstallId, platform);
+    }
 
-        curl_easy_cleanup(curl);
-        curl_slist_free_all(headers);
-        return responseString;
+    std::string CreateInstallRecordWithFingerprint(const std::string& authToken, const std::string& titleId,
+                                                 const std::string& userInstallId, const std::string& platform,
+                                                 const FingerprintComponents& fingerprint,
+                                                 const std::string& gameVersion,
+                                                 const std::string& referralSource)
+    {
+        return TitleContext::Get(authToken, titleId)->CreateInstallRecordWithFingerprint(
+            userInstallId, platform, fingerprint, gameVersion, referralSource);
+    }
+
+    std::string RecordPurchase(const std::string& authToken, const std::string& titleId, 
+                              const PurchaseData& purchaseData)
+    {
+        return TitleContext::Get(authToken, titleId)->RecordPurchase(purchaseData);
     }
 
     FingerprintComponents CollectSystemFingerprint() 
@@ -522,6 +1128,43 @@ namespace GlitchSDK
         return json.str();
     }
 
+    namespace
+    {
+        bool SameFingerprint(const FingerprintComponents& a, const FingerprintComponents& b)
+        {
+            return a.DeviceModel == b.DeviceModel && a.DeviceType == b.DeviceType && a.DeviceManufacturer == b.DeviceManufacturer &&
+                   a.OSName == b.OSName && a.OSVersion == b.OSVersion &&
+                   a.DisplayResolution == b.DisplayResolution && a.DisplayDensity == b.DisplayDensity &&
+                   a.CPUModel == b.CPUModel && a.CPUCores == b.CPUCores && a.GPUModel == b.GPUModel && a.MemoryMB == b.MemoryMB &&
+                   a.Language == b.Language && a.Timezone == b.Timezone && a.Region == b.Region &&
+                   a.FormFactors == b.FormFactors && a.Architecture == b.Architecture && a.Bitness == b.Bitness &&
+                   a.PlatformVersion == b.PlatformVersion && a.IsWow64 == b.IsWow64 &&
+                   a.KeyboardLayout == b.KeyboardLayout && a.AdvertisingID == b.AdvertisingID;
+        }
+    }
+
+    namespace Internal
+    {
+        std::shared_ptr<const JsonString> CachedFingerprintJSON(const FingerprintComponents& fingerprint)
+        {
+            // A device sends the same components every time, so one entry is enough
+            static std::mutex mutex;
+            static FingerprintComponents cachedComponents;
+            static std::shared_ptr<const JsonString> cachedJson;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (cachedJson && SameFingerprint(cachedComponents, fingerprint)) return cachedJson;
+            }
+
+            std::string json = FingerprintToJSON(fingerprint);
+            std::shared_ptr<const JsonString> serialized = std::make_shared<JsonString>(json.data(), json.size());
+            std::lock_guard<std::mutex> lock(mutex);
+            cachedComponents = fingerprint;
+            cachedJson = serialized;
+            return serialized;
+        }
+    }
+
     std::string PurchaseToJSON(const PurchaseData& purchase) 
     {
         std::stringstream json;
@@ -581,203 +1224,302 @@ namespace GlitchSDK
         return CreateInstallRecordWithFingerprint(titleToken, titleId, installId, "pc", CollectSystemFingerprint());
     }
 
-    std::string ValidateInstall(const std::string& titleToken, const std::string& titleId, const std::string& installId)
+    namespace
     {
-        CURL* curl = curl_easy_init();
-        std::string responseString;
-        if (!curl) return "Failed to init curl";
+        // /validate response with the status it came with
+        struct ValidateAnswer
+        {
+            std::string Response;
+            long Status = 0;                // 0 on transport failure
+        };
 
-        std::string url = "https://api.glitch.fun/api/titles/" + titleId + "/installs/" + installId + "/validate";
+        // One entry per (token, title, install). While a request is running,
+        // Inflight holds the future every concurrent caller waits on.
+        struct ValidateCacheEntry
+        {
+            std::shared_future<ValidateAnswer> Inflight;
+            ValidateAnswer Answer;
+            std::chrono::steady_clock::time_point Expires;
+            bool HasResponse = false;
+        };
 
-        struct curl_slist *headers = NULL;
-        headers = curl_slist_append(headers, "Content-Type: application/json");
-        std::string authHeader = "Authorization: Bearer " + titleToken;
-        headers = curl_slist_append(headers, authHeader.c_str());
+        std::mutex g_validateMutex;
+        std::unordered_map<std::string, ValidateCacheEntry> g_validateCache;
+        std::chrono::seconds g_validateTTL(60);
+        const size_t kValidatePruneMin = 64;
+        size_t g_validatePruneAt = kValidatePruneMin;   // Cache size that triggers the next prune
 
-        curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-        curl_easy_setopt(curl, CURLOPT_POST, 1L);
-        curl_easy_setopt(curl, CURLOPT_POSTFIELDS, "{}"); // Empty body for POST
-        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, Internal::WriteCallback);
-        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &responseString);
+        // Caller holds g_validateMutex. Drops entries with no live answer and no request in
+        // flight. Runs when the cache has doubled since the last prune, so inserts stay O(1)
+        // amortized and the cache stays within twice the installs validated in the last TTL.
+        void PruneValidateCache(bool force)
+        {
+            if (!force && g_validateCache.size() < g_validatePruneAt) return;
+            auto now = std::chrono::steady_clock::now();
+            for (auto it = g_validateCache.begin(); it != g_validateCache.end();) {
+                const ValidateCacheEntry& entry = it->second;
+                bool live = entry.Inflight.valid() || (entry.HasResponse && now < entry.Expires);
+                if (live) ++it;
+                else it = g_validateCache.erase(it);
+            }
+            g_validatePruneAt = std::max(kValidatePruneMin, g_validateCache.size() * 2);
+        }
 
-        CURLcode res = curl_easy_perform(curl);
-        curl_easy_cleanup(curl);
-        curl_slist_free_all(headers);
-        return responseString;
-    }
+        ValidateAnswer ValidateInstallUncached(const std::string& titleToken, const std::string& titleId,
+                                               const std::string& installId)
+        {
+            std::shared_ptr<const TitleContext> context = TitleContext::Get(titleToken, titleId);
+            static const std::string emptyBody = "{}"; // Empty body for POST
 
-    // --- 2. Aegis Cloud Save ---
+            ValidateAnswer answer;
+            answer.Response = context->Send(context->InstallUrl(installId, "/validate"), &emptyBody, &answer.Status);
+            return answer;
+        }
 
-    std::string ListSaves(const std::string& titleToken, const std::string& titleId, const std::string& installId)
-    {
-        CURL* curl = curl_easy_init();
-        std::string responseString;
-        std::string url = "https://api.glitch.fun/api/titles/" + titleId + "/installs/" + installId + "/saves";
+        // ValidateInstall, keeping the status for callers that act on it
+        ValidateAnswer ValidateInstallCached(const std::string& titleToken, const std::string& titleId, const std::string& installId)
+        {
+            std::string key = titleToken + '\n' + titleId + '\n' + installId;
+            std::promise<ValidateAnswer> promise;
+            std::shared_future<ValidateAnswer> inflight;
+            {
+                std::lock_guard<std::mutex> lock(g_validateMutex);
+                PruneValidateCache(false);
+                ValidateCacheEntry& entry = g_validateCache[key];
+                if (entry.HasResponse && std::chrono::steady_clock::now() < entry.Expires) {
+                    Internal::Counters().ValidateCacheHits.fetch_add(1, std::memory_order_relaxed);
+                    return entry.Answer;
+                }
+                if (entry.Inflight.valid()) {
+                    inflight = entry.Inflight;
+                    Internal::Counters().ValidateCoalesced.fetch_add(1, std::memory_order_relaxed);
+                } else {
+                    entry.Inflight = promise.get_future().share();
+                    Internal::Counters().ValidateCacheMisses.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+            if (inflight.valid()) return inflight.get();
+
+            ValidateAnswer answer;
+            try {
+                answer = ValidateInstallUncached(titleToken, titleId, installId);
+            } catch (...) {
+                // Free the slot and pass the error on, so waiters and later callers don't hit a broken promise
+                {
+                    std::lock_guard<std::mutex> lock(g_validateMutex);
+                    g_validateCache.erase(key);
+                }
+                promise.set_exception(std::current_exception());
+                throw;
+            }
 
-        struct curl_slist *headers = NULL;
-        std::string authHeader = "Authorization: Bearer " + titleToken;
-        headers = curl_slist_append(headers, authHeader.c_str());
+            // Only cache successes and definitive refusals (revoked or unknown install).
+            // 401, 408, 429, 5xx and transport failures are asked again on the next call.
+            bool cacheable = (answer.Status >= 200 && answer.Status < 300) || answer.Status == 403 || answer.Status == 404;
+            {
+                // Waiters hold their own copy of the future, so an uncached entry can go now
+                std::lock_guard<std::mutex> lock(g_validateMutex);
+                if (cacheable && g_validateTTL.count() > 0) {
+                    ValidateCacheEntry& entry = g_validateCache[key];
+                    entry.Inflight = std::shared_future<ValidateAnswer>();
+                    entry.HasResponse = true;
+                    entry.Answer = answer;
+                    entry.Expires = std::chrono::steady_clock::now() + g_validateTTL;
+                } else {
+                    g_validateCache.erase(key);
+                }
+            }
+            promise.set_value(answer);
+            return answer;
+        }
+    }
 
-        curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, Internal::WriteCallback);
-        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &responseString);
+    std::string ValidateInstall(const std::string& titleToken, const std::string& titleId, const std::string& installId)
+    {
+        return ValidateInstallCached(titleToken, titleId, installId).Response;
+    }
 
-        curl_easy_perform(curl);
-        curl_easy_cleanup(curl);
-        return responseString;
+    void SetValidateInstallCacheTTL(int seconds)
+    {
+        std::lock_guard<std::mutex> lock(g_validateMutex);
+        g_validateTTL = std::chrono::seconds(seconds > 0 ? seconds : 0);
+        if (seconds <= 0) {
+            for (auto& pair : g_validateCache) pair.second.HasResponse = false;
+            PruneValidateCache(true);
+        }
     }
 
-    std::string StoreSave(const std::string& titleToken, const std::string& titleId, const std::string& installId, const GameSaveData& saveData)
+    void ClearValidateInstallCache()
     {
-        CURL* curl = curl_easy_init();
-        std::string responseString;
-        std::string url = "https://api.glitch.fun/api/titles/" + titleId + "/installs/" + installId + "/saves";
+        std::lock_guard<std::mutex> lock(g_validateMutex);
+        for (auto& pair : g_validateCache) pair.second.HasResponse = false;
+        PruneValidateCache(true);
+    }
 
-        std::stringstream json;
-        json << "{"
-             << R"("slot_index":)" << saveData.SlotIndex << ","
-             << R"("payload":")" << saveData.PayloadBase64 << R"(",)"
-             << R"("checksum":")" << saveData.Checksum << R"(",)"
-             << R"("base_version":)" << saveData.BaseVersion << ","
-             << R"("save_type":")" << saveData.SaveType << R"(",)"
-             << R"("client_timestamp":")" << saveData.ClientTimestamp << R"(")";
-        if(!saveData.MetadataJSON.empty()) json << R"(,"metadata":)" << saveData.MetadataJSON;
-        json << "}";
+    namespace
+    {
+        struct OfflineLicenseConfig
+        {
+            std::shared_ptr<EVP_PKEY> PublicKey;
+            std::string TokenPath;
+            int GracePeriodSeconds = 0;
+        };
 
-        struct curl_slist *headers = NULL;
-        headers = curl_slist_append(headers, "Content-Type: application/json");
-        headers = curl_slist_append(headers, ("Authorization: Bearer " + titleToken).c_str());
+        std::mutex g_offlineMutex;
+        OfflineLicenseConfig g_offline;
 
-        curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-        curl_easy_setopt(curl, CURLOPT_POSTFIELDS, json.str().c_str());
-        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, Internal::WriteCallback);
-        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &responseString);
+        // Checks signature, subject and expiry; on success returns the claims JSON
+        bool VerifyLicenseToken(const OfflineLicenseConfig& config, const std::string& token,
+                                const std::string& titleId, const std::string& installId, std::string& claims)
+        {
+            size_t dot = token.find('.');
+            if (dot == std::string::npos || !config.PublicKey) return false;
 
-        curl_easy_perform(curl);
-        curl_easy_cleanup(curl);
-        return responseString;
-    }
+            std::string signature;
+            if (!Internal::Base64Decode(token.substr(dot + 1), signature) || signature.size() != 64) return false;
 
-    // --- 3. Behavioral Telemetry ---
+            EVP_MD_CTX* ctx = EVP_MD_CTX_new();
+            if (!ctx) return false;
+            bool verified = EVP_DigestVerifyInit(ctx, NULL, NULL, NULL, config.PublicKey.get()) == 1 &&
+                            EVP_DigestVerify(ctx, (const unsigned char*)signature.data(), signature.size(),
+                                             (const unsigned char*)token.data(), dot) == 1;
+            EVP_MD_CTX_free(ctx);
+            if (!verified) return false;
 
-    std::string RecordEvent(const std::string& titleToken, const std::string& titleId, const GameEventData& event)
-    {
-        CURL* curl = curl_easy_init();
-        std::string responseString;
-        std::string url = "https://api.glitch.fun/api/titles/" + titleId + "/events";
+            if (!Internal::Base64Decode(token.substr(0, dot), claims)) return false;
 
-        std::stringstream json;
-        json << "{"
-             << R"("game_install_id":")" << event.GameInstallID << R"(",)"
-             << R"("step_key":")" << Internal::EscapeJSON(event.StepKey) << R"(",)"
-             << R"("action_key":")" << Internal::EscapeJSON(event.ActionKey) << R"(")";
-        if(!event.MetadataJSON.empty()) json << R"(,"metadata":)" << event.MetadataJSON;
-        json << "}";
+            std::string tokenTitle, tokenInstall;
+            double expiresAt = 0;
+            if (!Internal::ExtractJSONString(claims, "title_id", tokenTitle) || tokenTitle != titleId) return false;
+            if (!Internal::ExtractJSONString(claims, "install_id", tokenInstall) || tokenInstall != installId) return false;
+            if (!Internal::ExtractJSONNumber(claims, "exp", expiresAt)) return false;
 
-        struct curl_slist *headers = NULL;
-        headers = curl_slist_append(headers, "Content-Type: application/json");
-        headers = curl_slist_append(headers, ("Authorization: Bearer " + titleToken).c_str());
+            return double(std::time(nullptr)) < expiresAt + config.GracePeriodSeconds;
+        }
 
-        curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-        curl_easy_setopt(curl, CURLOPT_POSTFIELDS, json.str().c_str());
-        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, Internal::WriteCallback);
-        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &responseString);
+        // Persist the token from a /validate response if it verifies. Written beside the target and
+        // renamed over it, so a crash mid-write never leaves a truncated or missing token behind.
+        void StoreLicenseToken(const OfflineLicenseConfig& config, const std::string& response,
+                               const std::string& titleId, const std::string& installId)
+        {
+            std::string token, claims;
+            if (!Internal::ExtractJSONString(response, "license_token", token)) return;
+            if (!VerifyLicenseToken(config, token, titleId, installId, claims)) return;
+
+            std::string tempPath = config.TokenPath + ".tmp";
+            {
+                std::ofstream file(tempPath.c_str(), std::ios::binary | std::ios::trunc);
+                if (!file.is_open()) return;
+                file << token;
+                if (!file.good()) return;
+            }
+            if (!Internal::RenameReplacing(tempPath, config.TokenPath)) std::remove(tempPath.c_str());
+        }
 
-        curl_easy_perform(curl);
-        curl_easy_cleanup(curl);
-        return responseString;
+        // Act on a /validate answer: a definitive refusal (revoked or unknown install) deletes the
+        // persisted token so it is not trusted offline again. A 401 only says the title token was
+        // bad, not the license, so it and anything else keep the token and store a fresh one if
+        // the response carries it
+        void UpdateLicenseToken(const OfflineLicenseConfig& config, const ValidateAnswer& answer,
+                                const std::string& titleId, const std::string& installId)
+        {
+            if (answer.Status == 403 || answer.Status == 404) {
+                std::remove(config.TokenPath.c_str());
+                return;
+            }
+            StoreLicenseToken(config, answer.Response, titleId, installId);
+        }
     }
 
-    // --- 4. Wishlist Intelligence ---
-
-    std::string ToggleWishlist(const std::string& userJwt, const std::string& titleId, const std::string& fingerprintId)
+    bool ConfigureOfflineLicense(const std::string& publicKeyBase64, const std::string& tokenPath, int gracePeriodSeconds)
     {
-        CURL* curl = curl_easy_init();
-        std::string responseString;
-        std::string url = "https://api.glitch.fun/api/titles/" + titleId + "/wishlist";
+        std::string rawKey;
+        if (!Internal::Base64Decode(publicKeyBase64, rawKey) || rawKey.size() != 32) return false;
+
+        EVP_PKEY* key = EVP_PKEY_new_raw_public_key(EVP_PKEY_ED25519, NULL,
+                                                    (const unsigned char*)rawKey.data(), rawKey.size());
+        if (!key) return false;
+
+        std::lock_guard<std::mutex> lock(g_offlineMutex);
+        g_offline.PublicKey = std::shared_ptr<EVP_PKEY>(key, EVP_PKEY_free);
+        g_offline.TokenPath = tokenPath;
+        g_offline.GracePeriodSeconds = gracePeriodSeconds > 0 ? gracePeriodSeconds : 0;
+        return true;
+    }
 
-        std::stringstream json;
-        json << "{";
-        if(!fingerprintId.empty()) json << R"("fingerprint_id":")" << fingerprintId << R"(")";
-        json << "}";
+    std::string ValidateInstallOffline(const std::string& titleToken, const std::string& titleId,
+                                       const std::string& installId,
+                                       std::function<void(const std::string&)> onRevalidated)
+    {
+        OfflineLicenseConfig config;
+        {
+            std::lock_guard<std::mutex> lock(g_offlineMutex);
+            config = g_offline;
+        }
 
-        struct curl_slist *headers = NULL;
-        headers = curl_slist_append(headers, "Content-Type: application/json");
-        headers = curl_slist_append(headers, ("Authorization: Bearer " + userJwt).c_str());
+        std::string token, claims;
+        if (config.PublicKey) {
+            std::ifstream file(config.TokenPath.c_str(), std::ios::binary);
+            if (file.is_open()) {
+                std::getline(file, token);
+            }
+        }
 
-        curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-        curl_easy_setopt(curl, CURLOPT_POSTFIELDS, json.str().c_str());
-        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, Internal::WriteCallback);
-        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &responseString);
+        if (!token.empty() && VerifyLicenseToken(config, token, titleId, installId, claims)) {
+            Internal::Counters().OfflineLicenseAccepted.fetch_add(1, std::memory_order_relaxed);
+            Internal::SubmitIO([=]() {
+                ValidateAnswer answer = ValidateInstallCached(titleToken, titleId, installId);
+                UpdateLicenseToken(config, answer, titleId, installId);
+                if (onRevalidated) onRevalidated(answer.Response);
+            });
+            return claims;
+        }
 
-        curl_easy_perform(curl);
-        curl_easy_cleanup(curl);
-        return responseString;
+        Internal::Counters().OfflineLicenseRejected.fetch_add(1, std::memory_order_relaxed);
+        ValidateAnswer answer = ValidateInstallCached(titleToken, titleId, installId);
+        if (config.PublicKey) UpdateLicenseToken(config, answer, titleId, installId);
+        return answer.Response;
     }
 
-    std::string RecordEventsBulk(const std::string& titleToken, const std::string& titleId, const std::vector<GameEventData>& events)
+    // --- 2. Aegis Cloud Save ---
+
+    std::string ListSaves(const std::string& titleToken, const std::string& titleId, const std::string& installId)
     {
-        CURL* curl = curl_easy_init();
-        std::string responseString;
-        if (!curl) return "Failed to init curl";
+        return TitleContext::Get(titleToken, titleId)->ListSaves(installId);
+    }
 
-        std::string url = "https://api.glitch.fun/api/titles/" + titleId + "/events/bulk";
+    std::string StoreSave(const std::string& titleToken, const std::string& titleId, const std::string& installId, const GameSaveData& saveData)
+    {
+        return TitleContext::Get(titleToken, titleId)->StoreSave(installId, saveData);
+    }
 
-        std::stringstream json;
-        json << R"({"events":[)";
-        for (size_t i = 0; i < events.size(); ++i) {
-            json << "{"
-                 << R"("game_install_id":")" << events[i].GameInstallID << R"(",)"
-                 << R"("step_key":")" << Internal::EscapeJSON(events[i].StepKey) << R"(",)"
-                 << R"("action_key":")" << Internal::EscapeJSON(events[i].ActionKey) << R"(")";
-            if(!events[i].MetadataJSON.empty()) json << R"(,"metadata":)" << events[i].MetadataJSON;
-            json << "}";
-            if (i < events.size() - 1) json << ",";
-        }
-        json << "]}";
+    // --- 3. Behavioral Telemetry ---
 
-        struct curl_slist *headers = NULL;
-        headers = curl_slist_append(headers, "Content-Type: application/json");
-        headers = curl_slist_append(headers, ("Authorization: Bearer " + titleToken).c_str());
+    std::string RecordEvent(const std::string& titleToken, const std::string& titleId, const GameEventData& event)
+    {
+        return TitleContext::Get(titleToken, titleId)->RecordEvent(event);
+    }
 
-        curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-        curl_easy_setopt(curl, CURLOPT_POSTFIELDS, json.str().c_str());
-        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, Internal::WriteCallback);
-        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &responseString);
+    // --- 4. Wishlist Intelligence ---
 
-        curl_easy_perform(curl);
-        curl_easy_cleanup(curl);
-        return responseString;
+    std::string ToggleWishlist(const std::string& userJwt, const std::string& titleId, const std::string& fingerprintId)
+    {
+        return TitleContext::Get(userJwt, titleId)->ToggleWishlist(fingerprintId);
     }
 
-    std::string UpdateWishlistScore(const std::string& userJwt, const std::string& titleId, int score)
+    std::string RecordEventsBulk(const std::string& titleToken, const std::string& titleId, const std::vector<GameEventData>& events)
     {
-        CURL* curl = curl_easy_init();
-        std::string responseString;
-        std::string url = "https://api.glitch.fun/api/titles/" + titleId + "/wishlist/score";
-
-        std::stringstream json;
-        json << R"({"score":)" << score << "}";
-
-        struct curl_slist *headers = NULL;
-        headers = curl_slist_append(headers, "Content-Type: application/json");
-        headers = curl_slist_append(headers, ("Authorization: Bearer " + userJwt).c_str());
+        return TitleContext::Get(titleToken, titleId)->RecordEventsBulk(events);
+    }
 
-        curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-        curl_easy_setopt(curl, CURLOPT_POSTFIELDS, json.str().c_str());
-        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, Internal::WriteCallback);
-        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &responseString);
+    BulkEventsResult SendEventsBulk(const std::string& titleToken, const std::string& titleId, const std::vector<GameEventData>& events)
+    {
+        return TitleContext::Get(titleToken, titleId)->SendEventsBulk(events);
+    }
 
-        curl_easy_perform(curl);
-        curl_easy_cleanup(curl);
-        return responseString;
+    std::string UpdateWishlistScore(const std::string& userJwt, const std::string& titleId, int score)
+    {
+        return TitleContext::Get(userJwt, titleId)->UpdateWishlistScore(score);
     }
 
     std::string ResolveSaveConflict(
@@ -788,33 +1530,344 @@ namespace GlitchSDK
         const std::string& conflictId, 
         const std::string& choice
     ) {
-        CURL* curl = curl_easy_init();
-        std::string responseString;
-        if (!curl) return "Failed to init curl";
+        return TitleContext::Get(titleToken, titleId)->ResolveSaveConflict(installId, saveId, conflictId, choice);
+    }
 
-        std::string url = "https://api.glitch.fun/api/titles/" + titleId + "/installs/" + installId + "/saves/" + saveId + "/resolve";
-        
-        std::stringstream json;
-        json << "{"
-             << R"("conflict_id":")" << conflictId << R"(",)"
-             << R"("choice":")" << choice << R"(")"
-             << "}";
+    // --- 4b. Wishlist coalescing ---
+
+    namespace
+    {
+        // Net change still to be sent for one (user, title)
+        struct WishlistPending
+        {
+            std::string UserJwt;
+            std::string TitleId;
+            std::string FingerprintId;
+            int ToggleCount = 0;
+            bool HasScore = false;
+            int Score = 0;
+            bool InFlight = false;          // A send for this key is running; changes collect here meanwhile
+            std::chrono::steady_clock::time_point LastUpdate;
+            std::chrono::steady_clock::time_point RetryAt; // Backoff after a retryable failure
+            int Failures = 0;
+            uint64_t FailedFlush = 0;       // Flush() round in which the last attempt failed
+        };
+
+        typedef Internal::TaggedMap<std::string, WishlistPending, MemoryTag::Queues> PendingMap;
+
+        // Pending updates are drained on the executor once their debounce window has passed
+        class WishlistCoalescer : public std::enable_shared_from_this<WishlistCoalescer>
+        {
+        public:
+            void Toggle(const std::string& userJwt, const std::string& titleId, const std::string& fingerprintId)
+            {
+                std::lock_guard<std::mutex> lock(Mutex);
+                WishlistPending& pending = Touch(userJwt, titleId);
+                pending.ToggleCount++;
+                if (!fingerprintId.empty()) pending.FingerprintId = fingerprintId;
+            }
+
+            void SetScore(const std::string& userJwt, const std::string& titleId, int score)
+            {
+                std::lock_guard<std::mutex> lock(Mutex);
+                WishlistPending& pending = Touch(userJwt, titleId);
+                pending.HasScore = true;
+                pending.Score = score;
+            }
 
-        struct curl_slist *headers = NULL;
-        headers = curl_slist_append(headers, "Content-Type: application/json");
-        headers = curl_slist_append(headers, ("Authorization: Bearer " + titleToken).c_str());
-
-        curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-        curl_easy_setopt(curl, CURLOPT_POST, 1L);
-        curl_easy_setopt(curl, CURLOPT_POSTFIELDS, json.str().c_str());
-        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, Internal::WriteCallback);
-        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &responseString);
-
-        curl_easy_perform(curl);
-        curl_easy_cleanup(curl);
-        curl_slist_free_all(headers);
-        return responseString;
+            void SetDebounce(int milliseconds)
+            {
+                std::lock_guard<std::mutex> lock(Mutex);
+                Debounce = std::chrono::milliseconds(milliseconds > 0 ? milliseconds : 0);
+                for (const auto& pair : Pending) ScheduleDrain(DueAt(pair.second, Debounce));
+            }
+
+            void SetCallback(std::function<void(const std::string&, const std::string&)> callback)
+            {
+                std::lock_guard<std::mutex> lock(Mutex);
+                Callback = callback;
+            }
+
+            // Aborts sends in flight; drains scheduled afterwards fail fast
+            void Shutdown()
+            {
+                Cancel.Cancel();
+            }
+
+            void Flush()
+            {
+                // Keys already being sent are picked up again once that send is done. Each key is
+                // tried until it fails once; what failed stays queued for the background retry.
+                std::unique_lock<std::mutex> lock(Mutex);
+                uint64_t round = ++FlushRounds;
+                for (;;) {
+                    ReadyList ready;
+                    TakeReady(round, ready);
+                    if (!ready.empty()) {
+                        SendReady(lock, ready, round);
+                    } else if (!AnyInFlight()) {
+                        return;
+                    } else {
+                        Idle.wait(lock);
+                    }
+                }
+            }
+
+        private:
+            typedef Internal::TaggedVector<WishlistPending, MemoryTag::Queues> ReadyList;
+
+            WishlistPending& Touch(const std::string& userJwt, const std::string& titleId)
+            {
+                Internal::Counters().WishlistCallsQueued.fetch_add(1, std::memory_order_relaxed);
+                WishlistPending& pending = Pending[userJwt + '\n' + titleId];
+                pending.UserJwt = userJwt;
+                pending.TitleId = titleId;
+                pending.LastUpdate = std::chrono::steady_clock::now();
+                if (!pending.InFlight) ScheduleDrain(DueAt(pending, Debounce));
+                return pending;
+            }
+
+            // Caller holds Mutex. An already scheduled earlier drain reschedules itself.
+            void ScheduleDrain(std::chrono::steady_clock::time_point due)
+            {
+                if (DrainScheduled && DrainAt <= due) return;
+                DrainScheduled = true;
+                DrainAt = due;
+                auto delay = std::chrono::duration_cast<std::chrono::milliseconds>(due - std::chrono::steady_clock::now());
+                std::weak_ptr<WishlistCoalescer> self = shared_from_this();
+                Internal::SubmitIOAfter(delay + std::chrono::milliseconds(1), [self]() {
+                    if (std::shared_ptr<WishlistCoalescer> coalescer = self.lock()) coalescer->Drain();
+                });
+            }
+
+            static std::chrono::steady_clock::time_point DueAt(const WishlistPending& pending,
+                                                               std::chrono::milliseconds debounce)
+            {
+                return std::max(pending.LastUpdate + debounce, pending.RetryAt);
+            }
+
+            // Caller holds Mutex. Moves out the changes that are due for keys with no send in
+            // flight, marking those keys in flight. A flush round (non-zero) takes every key that
+            // has not failed in that round. Returns when the next one is due.
+            std::chrono::steady_clock::time_point TakeReady(uint64_t flushRound, ReadyList& ready)
+            {
+                auto now = std::chrono::steady_clock::now();
+                auto nextDue = std::chrono::steady_clock::time_point::max();
+                for (auto& pair : Pending) {
+                    WishlistPending& pending = pair.second;
+                    if (pending.InFlight) continue;
+                    auto due = DueAt(pending, Debounce);
+                    if (flushRound ? pending.FailedFlush != flushRound : due <= now) {
+                        ready.push_back(pending);
+                        pending.ToggleCount = 0;
+                        pending.HasScore = false;
+                        pending.InFlight = true;
+                    } else if (due < nextDue) {
+                        nextDue = due;
+                    }
+                }
+                return nextDue;
+            }
+
+            // Caller holds lock. Sends without it, then keeps what changed during the send and
+            // merges back what failed with a retryable status, to be retried with backoff.
+            void SendReady(std::unique_lock<std::mutex>& lock, const ReadyList& ready, uint64_t flushRound = 0)
+            {
+                auto callback = Callback;
+                ReadyList failed;
+                failed.reserve(ready.size());
+                lock.unlock();
+                for (const WishlistPending& sent : ready) failed.push_back(Send(sent, callback));
+                lock.lock();
+
+                for (size_t i = 0; i < ready.size(); ++i) {
+                    const WishlistPending& sent = ready[i];
+                    const WishlistPending& unsent = failed[i];
+                    auto it = Pending.find(sent.UserJwt + '\n' + sent.TitleId);
+                    if (it == Pending.end()) continue;
+                    WishlistPending& pending = it->second;
+                    pending.InFlight = false;
+                    if (sent.HasScore && !unsent.HasScore && pending.HasScore && pending.Score == sent.Score) {
+                        pending.HasScore = false;
+                    }
+
+                    if (unsent.ToggleCount % 2 != 0 || unsent.HasScore) {
+                        // Toggles made meanwhile still count on top; a newer score replaces the failed one
+                        pending.ToggleCount += unsent.ToggleCount;
+                        if (unsent.HasScore && !pending.HasScore) {
+                            pending.HasScore = true;
+                            pending.Score = unsent.Score;
+                        }
+                        int failures = ++pending.Failures;
+                        int delaySeconds = failures < 6 ? (1 << failures) : 60;
+                        pending.RetryAt = std::chrono::steady_clock::now() + std::chrono::seconds(delaySeconds);
+                        if (flushRound) pending.FailedFlush = flushRound;
+                    } else {
+                        pending.Failures = 0;
+                        pending.RetryAt = std::chrono::steady_clock::time_point();
+                    }
+
+                    if (pending.ToggleCount % 2 == 0 && !pending.HasScore) Pending.erase(it);
+                    else ScheduleDrain(DueAt(pending, Debounce));
+                }
+                Idle.notify_all();
+            }
+
+            bool AnyInFlight() const
+            {
+                for (const auto& pair : Pending) {
+                    if (pair.second.InFlight) return true;
+                }
+                return false;
+            }
+
+            void Drain()
+            {
+                RequestOptions options;
+                options.Cancel = Cancel;
+                RequestScope scope(options);
+                std::unique_lock<std::mutex> lock(Mutex);
+                if (DrainScheduled && DrainAt <= std::chrono::steady_clock::now()) DrainScheduled = false;
+
+                ReadyList ready;
+                auto nextDue = TakeReady(0, ready);
+                if (nextDue != std::chrono::steady_clock::time_point::max()) ScheduleDrain(nextDue);
+                if (!ready.empty()) SendReady(lock, ready);
+            }
+
+            // Sends one key's changes. Returns the part that failed with a retryable status;
+            // every other response goes to the callback.
+            static WishlistPending Send(const WishlistPending& pending,
+                                        const std::function<void(const std::string&, const std::string&)>& callback)
+            {
+                WishlistPending failed;
+                std::shared_ptr<const TitleContext> context = TitleContext::Get(pending.UserJwt, pending.TitleId);
+                if (pending.ToggleCount % 2 != 0) {
+                    Internal::Counters().WishlistRequestsSent.fetch_add(1, std::memory_order_relaxed);
+                    long status = 0;
+                    std::string response = context->ToggleWishlist(pending.FingerprintId, &status);
+                    if (Internal::IsRetryableStatus(status)) failed.ToggleCount = pending.ToggleCount;
+                    else if (callback) callback(pending.TitleId, response);
+                }
+                if (pending.HasScore) {
+                    Internal::Counters().WishlistRequestsSent.fetch_add(1, std::memory_order_relaxed);
+                    long status = 0;
+                    std::string response = context->UpdateWishlistScore(pending.Score, &status);
+                    if (Internal::IsRetryableStatus(status)) {
+                        failed.HasScore = true;
+                        failed.Score = pending.Score;
+                    } else if (callback) {
+                        callback(pending.TitleId, response);
+                    }
+                }
+                return failed;
+            }
+
+            std::mutex Mutex;
+            std::condition_variable Idle;
+            PendingMap Pending;
+            std::function<void(const std::string&, const std::string&)> Callback;
+            std::chrono::milliseconds Debounce = std::chrono::milliseconds(2000);
+            std::chrono::steady_clock::time_point DrainAt;
+            bool DrainScheduled = false;
+            uint64_t FlushRounds = 0;
+            CancellationToken Cancel = CancellationToken::Create(); // Covers drains on the I/O threads
+        };
+
+        // Held by shared_ptr so drains still queued at exit find it gone instead of dangling.
+        // Created after the I/O pool so it is destroyed first, cancelling a send still running
+        // at exit before the pool joins its threads.
+        struct WishlistInstance
+        {
+            WishlistInstance()
+            {
+                Internal::IoExecutor();
+                Coalescer = std::make_shared<WishlistCoalescer>();
+            }
+            ~WishlistInstance() { Coalescer->Shutdown(); }
+
+            std::shared_ptr<WishlistCoalescer> Coalescer;
+        };
+
+        WishlistCoalescer& Wishlist()
+        {
+            static WishlistInstance instance;
+            return *instance.Coalescer;
+        }
+    }
+
+    void QueueWishlistToggle(const std::string& userJwt, const std::string& titleId, const std::string& fingerprintId)
+    {
+        Wishlist().Toggle(userJwt, titleId, fingerprintId);
+    }
+
+    void QueueWishlistScore(const std::string& userJwt, const std::string& titleId, int score)
+    {
+        Wishlist().SetScore(userJwt, titleId, score);
+    }
+
+    void SetWishlistDebounce(int milliseconds)
+    {
+        Wishlist().SetDebounce(milliseconds);
+    }
+
+    void SetWishlistResultCallback(std::function<void(const std::string& titleId, const std::string& response)> callback)
+    {
+        Wishlist().SetCallback(callback);
+    }
+
+    void FlushWishlistUpdates()
+    {
+        Wishlist().Flush();
+    }
+
+    // --- 5. Metrics ---
+
+    MetricsSnapshot GetMetrics()
+    {
+        const Internal::MetricCounters& c = Internal::Counters();
+        MetricsSnapshot snapshot;
+        snapshot.ValidateCacheHits = c.ValidateCacheHits.load(std::memory_order_relaxed);
+        snapshot.ValidateCacheMisses = c.ValidateCacheMisses.load(std::memory_order_relaxed);
+        snapshot.ValidateCoalesced = c.ValidateCoalesced.load(std::memory_order_relaxed);
+        snapshot.OfflineLicenseAccepted = c.OfflineLicenseAccepted.load(std::memory_order_relaxed);
+        snapshot.OfflineLicenseRejected = c.OfflineLicenseRejected.load(std::memory_order_relaxed);
+        snapshot.WishlistCallsQueued = c.WishlistCallsQueued.load(std::memory_order_relaxed);
+        snapshot.WishlistRequestsSent = c.WishlistRequestsSent.load(std::memory_order_relaxed);
+        snapshot.SavesUploaded = c.SavesUploaded.load(std::memory_order_relaxed);
+        snapshot.SavesSuperseded = c.SavesSuperseded.load(std::memory_order_relaxed);
+        snapshot.SaveConflicts = c.SaveConflicts.load(std::memory_order_relaxed);
+        snapshot.SavesRejected = c.SavesRejected.load(std::memory_order_relaxed);
+        snapshot.SavePartsSent = c.SavePartsSent.load(std::memory_order_relaxed);
+        snapshot.SavePartRetries = c.SavePartRetries.load(std::memory_order_relaxed);
+        snapshot.EventsQueued = c.EventsQueued.load(std::memory_order_relaxed);
+        snapshot.EventsDropped = c.EventsDropped.load(std::memory_order_relaxed);
+        snapshot.EventBatchesSent = c.EventBatchesSent.load(std::memory_order_relaxed);
+        snapshot.EventsAccepted = c.EventsAccepted.load(std::memory_order_relaxed);
+        snapshot.EventsRetried = c.EventsRetried.load(std::memory_order_relaxed);
+        snapshot.EventsDeadLettered = c.EventsDeadLettered.load(std::memory_order_relaxed);
+        snapshot.PurchasesDeadLettered = c.PurchasesDeadLettered.load(std::memory_order_relaxed);
+        snapshot.ItemsSpilled = c.ItemsSpilled.load(std::memory_order_relaxed);
+        snapshot.ItemsReplayed = c.ItemsReplayed.load(std::memory_order_relaxed);
+        snapshot.MetadataWrapped = c.MetadataWrapped.load(std::memory_order_relaxed);
+        snapshot.MetadataQuarantined = c.MetadataQuarantined.load(std::memory_order_relaxed);
+        snapshot.MetadataRejected = c.MetadataRejected.load(std::memory_order_relaxed);
+        snapshot.RequestTimeouts = c.RequestTimeouts.load(std::memory_order_relaxed);
+        snapshot.ConnectTimeouts = c.ConnectTimeouts.load(std::memory_order_relaxed);
+        snapshot.RequestsCancelled = c.RequestsCancelled.load(std::memory_order_relaxed);
+        snapshot.QueueBytes = c.MemoryBytes[size_t(MemoryTag::Queues)].load(std::memory_order_relaxed);
+        snapshot.QueueAllocations = c.MemoryAllocations[size_t(MemoryTag::Queues)].load(std::memory_order_relaxed);
+        snapshot.SerializationBytes = c.MemoryBytes[size_t(MemoryTag::Serialization)].load(std::memory_order_relaxed);
+        snapshot.SerializationAllocations = c.MemoryAllocations[size_t(MemoryTag::Serialization)].load(std::memory_order_relaxed);
+        snapshot.TransportBytes = c.MemoryBytes[size_t(MemoryTag::Transport)].load(std::memory_order_relaxed);
+        snapshot.TransportAllocations = c.MemoryAllocations[size_t(MemoryTag::Transport)].load(std::memory_order_relaxed);
+        snapshot.SaveBytes = c.MemoryBytes[size_t(MemoryTag::Saves)].load(std::memory_order_relaxed);
+        snapshot.SaveAllocations = c.MemoryAllocations[size_t(MemoryTag::Saves)].load(std::memory_order_relaxed);
+        for (size_t i = 0; i < size_t(Endpoint::Count); ++i) {
+            c.RequestLatency[i].Load(snapshot.RequestLatency[i]);
+            for (size_t phase = 0; phase < size_t(RequestPhase::Count); ++phase) c.RequestPhases[i][phase].Load(snapshot.RequestPhases[i][phase]);
+        }
+        return snapshot;
     }
 
 } // namespace GlitchSDK
@@ -1,6 +1,15 @@
 #pragma once
 
 #include <curl/curl.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <new>
+#include <mutex>
+#include <sstream>
 #include <string>
 #include <map>
 #include <vector>
@@ -17,6 +26,7 @@ namespace GlitchSDK
     // Forward declarations
     struct FingerprintComponents;
     struct PurchaseData;
+    struct BulkEventsResult;
     
     /**
      * Device fingerprint components for cross-platform user tracking
@@ -94,6 +104,7 @@ namespace GlitchSDK
         std::string SaveType;           // "manual", "auto", "checkpoint", "quicksave"
         std::string ClientTimestamp;    // ISO-8601 format
         std::string MetadataJSON;       // Optional extra info (level, map name, etc)
+        std::string Codec;              // Payload encoding: "" for raw, "zstd-dict:<id>" when compressed
     
         GameSaveData() : SlotIndex(0), BaseVersion(0), SaveType("manual") {}
     };
@@ -111,6 +122,703 @@ namespace GlitchSDK
         GameEventData() {}
     };
 
+    /**
+     * Check that text is exactly one well-formed JSON value (RFC 8259, UTF-8).
+     * String contents are scanned 16 bytes at a time on SSE2 and NEON targets.
+     * @param errorOffset Optional: receives the byte offset of the first error
+     * @return true if valid
+     */
+    bool IsValidJSON(const char* data, size_t size, size_t* errorOffset = nullptr);
+
+    inline bool IsValidJSON(const std::string& json, size_t* errorOffset = nullptr)
+    {
+        return IsValidJSON(json.data(), json.size(), errorOffset);
+    }
+
+    /**
+     * What queues do with an item whose MetadataJSON is not valid JSON
+     */
+    enum class MetadataPolicy
+    {
+        Reject,         // Refuse the item
+        Quarantine,     // Append the item to the quarantine file instead of sending it
+        WrapAsString    // Send the raw text as a JSON string value (default)
+    };
+
+    enum class QueueResult
+    {
+        Queued,
+        Wrapped,        // Queued with its metadata wrapped as a string
+        Quarantined,
+        Rejected
+    };
+
+    /**
+     * Subsystems whose heap usage is accounted separately in GetMetrics()
+     */
+    enum class MemoryTag
+    {
+        Queues,         // Pending wishlist updates, save sync state
+        Serialization,  // JSON request bodies
+        Transport,      // libcurl's own allocations
+        Saves,          // Save payload encoding/decoding buffers
+        Count
+    };
+
+    /**
+     * Host allocator hook. Implementations must be thread-safe; Deallocate
+     * receives the same size and tag that were passed to Allocate.
+     */
+    class IAllocator
+    {
+    public:
+        virtual ~IAllocator() {}
+        virtual void* Allocate(size_t size, size_t alignment, MemoryTag tag) = 0;
+        virtual void Deallocate(void* pointer, size_t size, MemoryTag tag) = 0;
+    };
+
+    /**
+     * Route the SDK's internal allocations through the host engine's allocator.
+     * Call once at startup, before any other SDK function, so libcurl picks it up
+     * too. Memory is always returned to the allocator that provided it, so the
+     * allocator must outlive the SDK.
+     * Strings passed to or returned from the public API stay on the global heap.
+     * @param allocator Host allocator; nullptr restores global operator new/delete
+     */
+    void SetAllocator(IAllocator* allocator);
+
+    IAllocator* GetAllocator();
+
+    /**
+     * Host job system hook for the SDK's CPU work: JSON serialization of large
+     * batches and save bodies, compression and hashing. Tasks never block on
+     * the network; requests run on a small pool of SDK-owned I/O threads.
+     */
+    class IExecutor
+    {
+    public:
+        virtual ~IExecutor() {}
+        virtual void Submit(std::function<void()> task) = 0;
+
+        // Tasks the executor can run at once, used to size parallel work; 0 if unknown
+        virtual unsigned GetConcurrency() const { return 0; }
+    };
+
+    enum class ThreadPriority
+    {
+        Normal,
+        BelowNormal,    // Default: yields to game and render threads
+        Idle
+    };
+
+    struct ExecutorConfig
+    {
+        unsigned Threads = 0;           // 0 = half the hardware threads, at least 2
+        ThreadPriority Priority = ThreadPriority::BelowNormal;
+    };
+
+    /**
+     * Default executor: a fixed pool where each worker owns a task deque and
+     * idle workers steal from the others. Tasks submitted from a worker stay
+     * on that worker's deque.
+     */
+    class WorkStealingExecutor : public IExecutor
+    {
+    public:
+        explicit WorkStealingExecutor(const ExecutorConfig& config = ExecutorConfig());
+        ~WorkStealingExecutor(); // Runs the tasks already queued, then stops the workers; at process exit queued tasks are discarded
+        void Submit(std::function<void()> task) override;
+        unsigned GetConcurrency() const override { return GetThreadCount(); }
+
+        unsigned GetThreadCount() const;
+
+        struct State;
+
+    private:
+        std::shared_ptr<State> Impl; // Shared with the workers so a worker can outlive the executor
+    };
+
+    /**
+     * Run the SDK's CPU work on the host's executor. Work already queued on
+     * the previous executor still runs there; a WorkStealingExecutor that is no
+     * longer referenced drains its queue before its workers stop.
+     * @param executor Executor to use; nullptr restores the default WorkStealingExecutor
+     */
+    void SetExecutor(std::shared_ptr<IExecutor> executor);
+
+    std::shared_ptr<IExecutor> GetExecutor();
+
+    /**
+     * Scatter-gather request body: buffers streamed to the transport in order
+     * without first being joined into one string. A segment either borrows
+     * memory that outlives the request or shares ownership through Owner.
+     */
+    class BodySegments
+    {
+    public:
+        void Append(const char* data, size_t size, std::shared_ptr<const void> owner = nullptr)
+        {
+            if (size == 0) return;
+            Segment segment;
+            segment.Data = data;
+            segment.Size = size;
+            segment.Owner = std::move(owner);
+            Segments.push_back(std::move(segment));
+            TotalSize += size;
+        }
+
+        template <size_t N>
+        void AppendLiteral(const char (&literal)[N]) { Append(literal, N - 1); }
+
+        size_t Size() const { return TotalSize; }
+        size_t Count() const { return Segments.size(); }
+
+        // HttpRequest::BodyReader contract; Rewind() starts over for a resend
+        size_t Read(char* buffer, size_t size);
+        void Rewind() { Index = 0; Offset = 0; }
+
+    private:
+        struct Segment
+        {
+            const char* Data;
+            size_t Size;
+            std::shared_ptr<const void> Owner;
+        };
+
+        std::vector<Segment> Segments;
+        size_t TotalSize = 0;
+        size_t Index = 0;
+        size_t Offset = 0;
+    };
+
+    // --- Deadlines and cancellation ---
+
+    /**
+     * Cooperative cancellation flag. Copies share one flag, so keep a token per
+     * level or session and Cancel() it on level change or shutdown: requests
+     * carrying a copy fail fast, and curl transfers already in flight abort
+     * within about a second. A default-constructed token is never cancelled.
+     */
+    class CancellationToken
+    {
+    public:
+        static CancellationToken Create()
+        {
+            CancellationToken token;
+            token.Flag = std::make_shared<std::atomic<bool> >(false);
+            return token;
+        }
+
+        void Cancel() const { if (Flag) Flag->store(true, std::memory_order_relaxed); }
+        bool IsCancelled() const { return Flag && Flag->load(std::memory_order_relaxed); }
+        bool CanBeCancelled() const { return Flag != nullptr; }
+
+    private:
+        std::shared_ptr<std::atomic<bool> > Flag;
+    };
+
+    // Groups of endpoints that share default limits
+    enum class Endpoint
+    {
+        Installs,       // Install records and heartbeats
+        Validate,       // License checks at startup
+        Purchases,
+        Events,         // Single and bulk events
+        Wishlist,
+        Saves,          // Cloud saves, including streamed and chunked transfers
+        Count
+    };
+
+    /**
+     * Limits applied to every request to an endpoint group. Zero disables a limit.
+     * The low-speed pair catches a stalled connection on transfers too large for
+     * a fixed total timeout.
+     */
+    struct TimeoutPolicy
+    {
+        std::chrono::milliseconds Connect{0};   // DNS, TCP and TLS
+        std::chrono::milliseconds Total{0};     // Whole request
+        long LowSpeedBytes = 0;                 // Abort when slower than this many bytes/s...
+        std::chrono::seconds LowSpeedTime{0};   // ...for this long
+    };
+
+    /**
+     * Change the default limits of an endpoint group. Defaults: 10 s connect for
+     * every group; 30 s total for Installs, Purchases and Events, 10 s for Validate,
+     * 15 s for Wishlist; Saves have no total limit but abort below 1 KB/s for 30 s.
+     */
+    void SetTimeoutPolicy(Endpoint endpoint, const TimeoutPolicy& policy);
+
+    TimeoutPolicy GetTimeoutPolicy(Endpoint endpoint);
+
+    struct RequestOptions
+    {
+        std::chrono::steady_clock::time_point Deadline = std::chrono::steady_clock::time_point::max(); // Default: none
+        CancellationToken Cancel;
+        std::string TraceId;    // 32 lowercase hex digits shared by every request in the scope; empty = one per request
+    };
+
+    /**
+     * Applies a deadline and cancellation token to every SDK request made on the
+     * calling thread while the scope is alive, on top of the endpoint's limits.
+     * Requests the SDK sends from its own threads (Client, SaveSyncWorker,
+     * coalesced wishlist calls) are not affected. Scopes nest: an inner scope can
+     * only bring the deadline forward, and its token, if any, replaces the outer one.
+     *
+     *   GlitchSDK::RequestOptions options;
+     *   options.Deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+     *   options.Cancel = levelToken;
+     *   GlitchSDK::RequestScope scope(options);
+     *   GlitchSDK::ValidateInstall(token, titleId, installId);
+     */
+    class RequestScope
+    {
+    public:
+        explicit RequestScope(const RequestOptions& options);
+        ~RequestScope();
+
+        RequestScope(const RequestScope&) = delete;
+        RequestScope& operator=(const RequestScope&) = delete;
+
+        // Innermost scope on this thread, or nullptr
+        static const RequestScope* Current();
+        const RequestOptions& GetOptions() const { return Options; }
+
+    private:
+        RequestOptions Options;
+        const RequestScope* Outer;
+    };
+
+    // Why HttpResponse::Error is set
+    enum class RequestFailure
+    {
+        None,
+        Other,              // Any other transport error (DNS, refused, reset, TLS...)
+        ConnectTimeout,     // No connection within the connect limit
+        Timeout,            // Total limit, deadline or low-speed limit hit
+        Cancelled           // The request's CancellationToken was cancelled
+    };
+
+    /**
+     * Where a request's time went, in seconds from its start, as curl reports them.
+     * Each value includes the ones before it; phases the transfer did not reach are 0.
+     */
+    struct RequestTiming
+    {
+        double NameLookup = 0.0;    // DNS resolved
+        double Connect = 0.0;       // TCP connected
+        double AppConnect = 0.0;    // TLS handshake done (0 for plain http)
+        double PreTransfer = 0.0;   // About to send the request
+        double StartTransfer = 0.0; // First response byte
+        double Total = 0.0;
+    };
+
+    // Intervals between RequestTiming points, recorded as per-endpoint histograms
+    enum class RequestPhase
+    {
+        NameLookup,     // Start to NameLookup
+        Connect,        // NameLookup to Connect
+        Tls,            // Connect to AppConnect
+        Server,         // PreTransfer to StartTransfer: upload plus server processing
+        Download,       // StartTransfer to Total
+        Count
+    };
+
+    /**
+     * One HTTP request as the SDK hands it to the transport. The body is either
+     * a contiguous string or produced on demand by BodyReader (streaming uploads).
+     */
+    struct HttpRequest
+    {
+        const char* Method = "GET";
+        std::string Url;
+        const curl_slist* Headers = nullptr;    // Not owned; usually a TitleContext list
+        const char* Body = nullptr;             // Not owned; nullptr when BodyReader is used or for GET
+
+        // Streaming body: fill buffer, return bytes written, 0 at the end,
+        // or CURL_READFUNC_ABORT to abort the request
+        std::function<size_t(char* buffer, size_t size)> BodyReader;
+        long long BodySize = -1;                // Length of Body, or of the BodyReader stream if known, else -1
+
+        // Optional: restart BodyReader from the first byte, false if it cannot. Lets curl
+        // resend a streamed body after a redirect or an auth or connection retry.
+        std::function<bool()> BodyRewind;
+
+        void SetBody(const char* data, size_t size)
+        {
+            Body = data;
+            BodySize = (long long)size;
+        }
+
+        // Stream segments (which must outlive the request) as the body
+        void SetBody(BodySegments& segments)
+        {
+            Body = nullptr;
+            segments.Rewind();
+            BodyReader = [&segments](char* buffer, size_t size) { return segments.Read(buffer, size); };
+            BodyRewind = [&segments]() { segments.Rewind(); return true; };
+            BodySize = (long long)segments.Size();
+        }
+
+        // Optional: receives the body of 2xx responses as it arrives instead of
+        // HttpResponse::Body. Return false to abort. Error bodies still go to Body.
+        std::function<bool(const char* data, size_t size)> ResponseSink;
+
+        // Limits, zero for none. Internal::SendRequest fills them from the endpoint's
+        // TimeoutPolicy and the thread's RequestScope; Timeout already includes the deadline.
+        std::chrono::milliseconds ConnectTimeout{0};
+        std::chrono::milliseconds Timeout{0};
+        long LowSpeedBytes = 0;
+        std::chrono::seconds LowSpeedTime{0};
+        CancellationToken Cancel;               // Transports abort the request once it is cancelled
+        char TraceParent[56] = "";              // W3C traceparent header value; set by Internal::SendRequest
+    };
+
+    struct HttpResponse
+    {
+        long StatusCode = 0;            // 0 if no HTTP response was received
+        std::string Body;
+        std::string Error;              // Transport failure ("CURL error: ..."), empty otherwise
+        RequestFailure Failure = RequestFailure::None;
+        RequestTiming Timing;           // Filled by CurlTransport; other transports may leave it at 0
+        std::chrono::seconds RetryAfter{0}; // The response's Retry-After (delay or HTTP date); 0 if none
+    };
+
+    /**
+     * What happened to one request, passed to the request observer when it completes
+     */
+    struct RequestRecord
+    {
+        Endpoint Group = Endpoint::Installs;
+        const char* Method = "";
+        const char* Url = "";
+        const char* TraceParent = "";   // The traceparent header sent; its second field is the trace ID
+        long StatusCode = 0;
+        RequestFailure Failure = RequestFailure::None;
+        RequestTiming Timing;           // Total is the SDK's own measurement if the transport gave none
+    };
+
+    /**
+     * Called on the sending thread after every request, for logging slow calls or
+     * correlating them with server traces. Keep it cheap; the pointers in the
+     * record are only valid during the call.
+     * @param observer Callback; nullptr removes it
+     */
+    void SetRequestObserver(std::function<void(const RequestRecord&)> observer);
+
+    /**
+     * Everything the SDK sends goes through the active transport, so the network
+     * can be swapped out for deterministic tests and benchmarks.
+     * Implementations must be safe to call from several threads at once.
+     */
+    class ITransport
+    {
+    public:
+        virtual ~ITransport() {}
+        virtual HttpResponse Send(const HttpRequest& request) = 0;
+    };
+
+    /**
+     * Default transport. Keeps one curl handle per thread so connections,
+     * TLS sessions and DNS results are reused between requests.
+     */
+    class CurlTransport : public ITransport
+    {
+    public:
+        HttpResponse Send(const HttpRequest& request) override;
+    };
+
+    /**
+     * In-process stand-in for the Glitch API. Answers installs, validation,
+     * purchases, events, wishlist and cloud saves (including chunked uploads)
+     * from in-memory state, with no sockets involved. Use it to measure the
+     * SDK's own overhead or to run games and tools offline.
+     */
+    class LoopbackTransport : public ITransport
+    {
+    public:
+        LoopbackTransport();
+        ~LoopbackTransport();
+        HttpResponse Send(const HttpRequest& request) override;
+
+        uint64_t GetRequestCount() const;
+        void Reset(); // Forget all installs, saves and counters
+
+    private:
+        struct State;
+        std::unique_ptr<State> Impl;
+    };
+
+    /**
+     * Network conditions applied by FaultInjectionTransport. Rates are the
+     * probability per request, from 0 to 1; zero everywhere means a clean network.
+     */
+    struct NetworkFaults
+    {
+        std::chrono::milliseconds Latency{0};   // Added to every request (connect plus first byte)
+        std::chrono::milliseconds Jitter{0};    // Uniform extra delay, 0 to Jitter
+        long BandwidthBytesPerSecond = 0;       // Caps request and response bodies; 0 for no cap
+        double ResetRate = 0.0;                 // Connection reset before the server sees the request
+        double LostResponseRate = 0.0;          // Reset after the server handled it, so a retry duplicates it
+        double SlowLorisRate = 0.0;             // Response trickles in until the request's timeout
+        std::chrono::milliseconds SlowLorisHold{60000}; // When the server gives up on a slow-loris response
+        double ThrottleRate = 0.0;              // Answered 429
+        double ServerErrorRate = 0.0;           // Starts a burst of 503s
+        int ServerErrorBurst = 1;               // Requests in a row each burst fails
+        std::chrono::seconds RetryAfter{0};     // Retry-After sent with the 429s and 503s; 0 sends none
+    };
+
+    /**
+     * One step of a fault script: Faults apply for Duration, then the next step
+     */
+    struct FaultPhase
+    {
+        std::chrono::milliseconds Duration{0};
+        NetworkFaults Faults;
+    };
+
+    /**
+     * What FaultInjectionTransport did, cumulative since construction
+     */
+    struct FaultInjectionStats
+    {
+        uint64_t Requests = 0;
+        uint64_t Forwarded = 0;         // Reached the inner transport
+        uint64_t Resets = 0;
+        uint64_t LostResponses = 0;
+        uint64_t SlowLoris = 0;
+        uint64_t Throttled = 0;
+        uint64_t ServerErrors = 0;
+        uint64_t TimedOut = 0;          // Gave up at the request's timeout while delayed
+        uint64_t Cancelled = 0;
+    };
+
+    /**
+     * Forwards to another transport (usually LoopbackTransport) through a
+     * simulated bad network. Delays are real sleeps that honour the request's
+     * Timeout, LowSpeedBytes/LowSpeedTime and CancellationToken the way
+     * CurlTransport does, and failures look like curl's. A script changes
+     * the faults over time; after its last phase that phase stays in effect,
+     * or the script starts over if it loops.
+     */
+    class FaultInjectionTransport : public ITransport
+    {
+    public:
+        FaultInjectionTransport(std::shared_ptr<ITransport> inner, const NetworkFaults& faults = NetworkFaults(), uint64_t seed = 1);
+        ~FaultInjectionTransport();
+        HttpResponse Send(const HttpRequest& request) override;
+
+        void SetFaults(const NetworkFaults& faults); // Replaces any script
+        void SetScript(const std::vector<FaultPhase>& script, bool loop = false); // Starts now
+        NetworkFaults GetFaults() const;            // In effect right now
+        FaultInjectionStats GetStats() const;
+
+    private:
+        struct State;
+        std::shared_ptr<ITransport> Inner;
+        std::unique_ptr<State> Impl;
+    };
+
+    /**
+     * One request/response pair captured by RecordingTransport
+     */
+    struct RecordedExchange
+    {
+        std::string Method;
+        std::string Url;
+        std::string RequestBody;
+        long StatusCode = 0;
+        std::string ResponseBody;
+        std::string Error;
+        double Seconds = 0.0;           // Time spent in the inner transport
+    };
+
+    /**
+     * Forwards to another transport and keeps a copy of every exchange
+     */
+    class RecordingTransport : public ITransport
+    {
+    public:
+        explicit RecordingTransport(std::shared_ptr<ITransport> inner);
+        HttpResponse Send(const HttpRequest& request) override;
+
+        std::vector<RecordedExchange> GetExchanges() const;
+        void Clear();
+
+    private:
+        std::shared_ptr<ITransport> Inner;
+        mutable std::mutex Mutex;
+        std::vector<RecordedExchange> Exchanges;
+    };
+
+    /**
+     * Answers requests from previously recorded exchanges. Each request is
+     * matched to the first unused exchange with the same method and URL.
+     */
+    class ReplayTransport : public ITransport
+    {
+    public:
+        explicit ReplayTransport(const std::vector<RecordedExchange>& exchanges);
+        HttpResponse Send(const HttpRequest& request) override;
+
+        size_t GetUnusedCount() const;  // Recorded exchanges not requested yet
+
+    private:
+        mutable std::mutex Mutex;
+        std::vector<RecordedExchange> Exchanges;
+        std::vector<bool> Used;
+    };
+
+    /**
+     * One request from a binary traffic trace
+     */
+    struct TraceRecord
+    {
+        uint64_t OffsetMicros = 0;      // Start time relative to the start of the capture
+        uint64_t DurationMicros = 0;    // Time spent in the inner transport
+        std::string Method;
+        std::string Url;
+        std::vector<std::string> Headers; // Authorization values are redacted
+        std::string RequestBody;
+        long StatusCode = 0;
+        uint64_t ResponseBytes = 0;     // Only the size of the response is kept
+    };
+
+    /**
+     * Forwards to another transport and appends every request to a compact
+     * binary trace file (varint-encoded, one record per request) as it completes.
+     */
+    class TraceCaptureTransport : public ITransport
+    {
+    public:
+        TraceCaptureTransport(std::shared_ptr<ITransport> inner, const std::string& path);
+        ~TraceCaptureTransport();
+        HttpResponse Send(const HttpRequest& request) override;
+
+        bool IsOpen() const;
+        uint64_t GetRecordCount() const;
+        std::shared_ptr<ITransport> GetInner() const { return Inner; }
+
+    private:
+        std::shared_ptr<ITransport> Inner;
+        mutable std::mutex Mutex;
+        std::FILE* File = nullptr;
+        uint64_t Records = 0;
+        std::chrono::steady_clock::time_point Start;
+    };
+
+    /**
+     * Wrap the active transport in a TraceCaptureTransport writing to path
+     * @return false if the trace file could not be created
+     */
+    bool StartTrafficCapture(const std::string& path);
+
+    /**
+     * Stop capturing and restore the transport that was active before
+     */
+    void StopTrafficCapture();
+
+    /**
+     * Load a trace written by TraceCaptureTransport
+     * @return false if the file is missing or not a valid trace
+     */
+    bool ReadTrafficTrace(const std::string& path, std::vector<TraceRecord>& records);
+
+    /**
+     * Route all SDK requests through a transport
+     * @param transport Transport to use; nullptr restores the default CurlTransport
+     */
+    void SetTransport(std::shared_ptr<ITransport> transport);
+
+    std::shared_ptr<ITransport> GetTransport();
+
+    /**
+     * Everything that only depends on (bearer token, titleId): endpoint URLs
+     * and the request header lists, built once and shared by every call.
+     * The free functions below look up a cached context per (token, titleId);
+     * long-lived callers can hold one from TitleContext::Get and call it directly.
+     * A context is immutable after construction and safe to use from any thread.
+     */
+    class TitleContext
+    {
+    public:
+        TitleContext(const std::string& bearerToken, const std::string& titleId);
+        ~TitleContext();
+
+        TitleContext(const TitleContext&) = delete;
+        TitleContext& operator=(const TitleContext&) = delete;
+
+        /**
+         * Shared context for a (token, titleId) pair, created on first use.
+         * The 64 most recently used pairs are kept; older ones are rebuilt on demand.
+         */
+        static std::shared_ptr<const TitleContext> Get(const std::string& bearerToken, const std::string& titleId);
+
+        const std::string& GetTitleId() const { return TitleId; }
+
+        // Precomputed endpoint URLs
+        const std::string& InstallsUrl() const { return Installs; }
+        const std::string& PurchasesUrl() const { return Purchases; }
+        const std::string& EventsUrl() const { return Events; }
+        const std::string& EventsBulkUrl() const { return EventsBulk; }
+        const std::string& WishlistUrl() const { return Wishlist; }
+        const std::string& WishlistScoreUrl() const { return WishlistScore; }
+        std::string InstallUrl(const std::string& installId, const char* suffix) const; // .../installs/{id}{suffix}
+
+        // Header lists owned by the context. Pass to CURLOPT_HTTPHEADER; never free or append.
+        curl_slist* JsonHeaders() const { return JsonHeaderList; }  // Content-Type + Authorization
+        curl_slist* AuthHeaders() const { return AuthHeaderList; }  // Authorization only
+        const std::string& AuthorizationHeader() const { return Authorization; }
+
+        // Title-scoped API; same behaviour as the free functions of the same name
+        std::string CreateInstallRecord(const std::string& userInstallId, const std::string& platform) const;
+        std::string CreateInstallRecordWithFingerprint(const std::string& userInstallId, const std::string& platform,
+                                                       const FingerprintComponents& fingerprint,
+                                                       const std::string& gameVersion = "",
+                                                       const std::string& referralSource = "") const;
+        std::string RecordPurchase(const PurchaseData& purchaseData, long* status = nullptr) const;
+        std::string ListSaves(const std::string& installId) const;
+        std::string StoreSave(const std::string& installId, const GameSaveData& saveData, long* status = nullptr) const;
+        std::string ResolveSaveConflict(const std::string& installId, const std::string& saveId,
+                                        const std::string& conflictId, const std::string& choice) const;
+        std::string RecordEvent(const GameEventData& event) const;
+        std::string RecordEventsBulk(const std::vector<GameEventData>& events, long* status = nullptr) const;
+        BulkEventsResult SendEventsBulk(const std::vector<GameEventData>& events) const;
+        std::string ToggleWishlist(const std::string& fingerprintId = "", long* status = nullptr) const;
+        std::string UpdateWishlistScore(int score, long* status = nullptr) const;
+
+        /**
+         * Send a request with the context's headers through the active transport
+         * @param body POST body, or nullptr for GET
+         * @param status Optional: receives the HTTP status (0 on transport failure)
+         * @return Response body, or "CURL error: ..." on transport failure
+         */
+        std::string Send(const std::string& url, const std::string* body, long* status = nullptr) const
+        {
+            return body ? Send(url, body->data(), body->size(), status) : Send(url, nullptr, 0, status);
+        }
+
+        std::string Send(const std::string& url, const char* body, size_t bodySize, long* status = nullptr) const;
+
+        // POST a scatter-gather body without joining its segments
+        std::string Send(const std::string& url, BodySegments& body, long* status = nullptr) const;
+
+    private:
+        std::string TitleId;
+        std::string Authorization;
+        std::string Installs;
+        std::string Purchases;
+        std::string Events;
+        std::string EventsBulk;
+        std::string Wishlist;
+        std::string WishlistScore;
+        curl_slist* JsonHeaderList = nullptr;
+        curl_slist* AuthHeaderList = nullptr;
+
+        Endpoint EndpointFor(const std::string& url) const;
+        HttpResponse PostEventsBulk(const std::vector<GameEventData>& events) const;
+    };
+
 
     // Updated to include analyticsSessionId for idle/fraud detection
     std::string SendHeartbeat(
@@ -120,12 +828,59 @@ namespace GlitchSDK
         const std::string& analyticsSessionId = ""
     );
 
-    // The Aegis Handshake: Verify license on startup
+    // The Aegis Handshake: Verify license on startup.
+    // Concurrent calls for the same install share one in-flight request, and
+    // successful responses and definitive 403/404 refusals are cached (see SetValidateInstallCacheTTL).
     std::string ValidateInstall(
         const std::string& titleToken,
         const std::string& titleId,
         const std::string& installId
     );
+
+    /**
+     * Set how long a successful ValidateInstall response is reused
+     * @param seconds Cache lifetime; 0 disables caching (default: 60)
+     */
+    void SetValidateInstallCacheTTL(int seconds);
+
+    /**
+     * Drop all cached ValidateInstall responses (e.g. after a license change)
+     */
+    void ClearValidateInstallCache();
+
+    /**
+     * Enable offline license validation.
+     * Successful /validate responses carry a "license_token" signed by Glitch
+     * (base64url(claims) "." base64url(Ed25519 signature over the first segment)).
+     * The SDK persists the latest token and can verify it locally at startup.
+     * @param publicKeyBase64 Glitch Ed25519 public key (32 raw bytes, base64)
+     * @param tokenPath File the last verified token is stored in
+     * @param gracePeriodSeconds How long an expired token is still accepted
+     * @return false if the public key could not be loaded
+     */
+    bool ConfigureOfflineLicense(
+        const std::string& publicKeyBase64,
+        const std::string& tokenPath,
+        int gracePeriodSeconds = 0
+    );
+
+    /**
+     * Startup-friendly variant of ValidateInstall.
+     * If the persisted token verifies (signature, title, install, expiry + grace)
+     * its claims JSON is returned immediately and /validate is called on a
+     * background thread to refresh the token. Otherwise this blocks on
+     * ValidateInstall exactly like the online path. A 403 or 404 from
+     * /validate on either path deletes the persisted token; a 401 (bad title
+     * token) keeps it.
+     * @param onRevalidated Optional callback with the background /validate response
+     * @return Token claims JSON, or the /validate response on the blocking path
+     */
+    std::string ValidateInstallOffline(
+        const std::string& titleToken,
+        const std::string& titleId,
+        const std::string& installId,
+        std::function<void(const std::string&)> onRevalidated = nullptr
+    );
     
     /**
      * Core Functions
@@ -215,6 +970,212 @@ namespace GlitchSDK
 
     std::string StoreSave(const std::string& titleToken, const std::string& titleId, const std::string& installId, const GameSaveData& saveData);
 
+    /**
+     * Load the zstd dictionary the game ships for its save files.
+     * Train it offline from sample saves (zstd --train <sample saves> -o saves.dict).
+     * Once set, StoreSaveRaw compresses payloads before base64 and records the
+     * codec in the save. Requires building with GLITCH_WITH_ZSTD=1.
+     * @param dictionary Raw dictionary bytes
+     * @param level zstd compression level
+     * @return false if the dictionary is invalid or zstd support is not compiled in
+     */
+    bool SetSaveCompressionDictionary(const std::string& dictionary, int level = 3);
+
+    /**
+     * Store a save from its raw bytes. Checksum is computed here, the payload is
+     * compressed with the save dictionary (if set) and base64-encoded directly
+     * into the request body. PayloadBase64, Checksum and Codec of saveData are ignored.
+     * @return Response string from the API
+     */
+    std::string StoreSaveRaw(
+        const std::string& titleToken,
+        const std::string& titleId,
+        const std::string& installId,
+        const GameSaveData& saveData,
+        const void* data,
+        size_t size
+    );
+
+    /**
+     * Store a save straight from a file on disk. The file is memory-mapped
+     * read-only and hashed, compressed (if a dictionary is set), base64-encoded
+     * and uploaded in fixed-size chunks, so heap usage does not grow with the
+     * save size. PayloadBase64, Checksum and Codec of saveData are ignored.
+     * @param filePath Path of the save file
+     * @return Response string from the API
+     */
+    std::string StoreSaveFromFile(
+        const std::string& titleToken,
+        const std::string& titleId,
+        const std::string& installId,
+        const GameSaveData& saveData,
+        const std::string& filePath
+    );
+
+    /**
+     * State of a resumable chunked save upload. Persist all of it (e.g. next to
+     * the save file) to resume an interrupted upload after a restart. A session
+     * is only resumed for the same file contents and codec it was started with;
+     * otherwise a fresh upload is started.
+     *
+     * Protocol (all under /titles/{titleId}/installs/{installId}/saves/uploads):
+     *   POST   /uploads                  save fields  -> {"upload_id", "part_size"}
+     *   PUT    /uploads/{id}/parts/{n}   base64 text of part n, X-Part-Checksum: SHA-256 of the part
+     *   GET    /uploads/{id}                           -> {"next_part"} (parts acknowledged so far)
+     *   POST   /uploads/{id}/complete    {"parts", "checksum", "codec"} -> same response as StoreSave
+     * The server concatenates the parts into the save's base64 payload.
+     */
+    struct SaveUploadSession
+    {
+        std::string UploadId;           // Empty to start a new upload
+        size_t PartSize = 1024 * 1024;  // Requested part size; the server may override it
+        size_t PartsAcknowledged = 0;   // Parts the server has confirmed
+        uint64_t SourceSize = 0;        // Size of the file the upload was started with
+        std::string SourceChecksum;     // SHA-256 (hex) of that file
+        std::string Codec;              // Codec its parts were encoded with
+    };
+
+    /**
+     * Upload a save file in fixed-size parts with per-part checksums. Failed
+     * parts are retried with backoff; if the upload still fails, call again with
+     * the same session to resume from the last part the server acknowledged.
+     * The file is memory-mapped and streamed like StoreSaveFromFile.
+     * @param session In/out upload state
+     * @param maxRetriesPerPart Attempts per part before giving up
+     * @return Response of the completion request, or an error string
+     */
+    std::string StoreSaveChunked(
+        const std::string& titleToken,
+        const std::string& titleId,
+        const std::string& installId,
+        const GameSaveData& saveData,
+        const std::string& filePath,
+        SaveUploadSession& session,
+        int maxRetriesPerPart = 5
+    );
+
+    /**
+     * Outcome of DownloadSave / DownloadSaveToFile
+     */
+    struct SaveDownloadResult
+    {
+        bool Success = false;           // Transfer completed and checksum verified
+        std::string Error;              // "CURL error: ...", "HTTP 404", "Checksum mismatch", ...
+        long StatusCode = 0;            // HTTP status
+        std::string Checksum;           // SHA-256 (hex) of the bytes delivered
+        std::string Codec;              // Codec the payload was stored with
+        int Version = 0;                // Server version of the save (use as BaseVersion)
+        size_t Bytes = 0;               // Raw bytes delivered to the sink
+        std::string Response;           // Response body with the payload left out
+    };
+
+    /**
+     * Download one save slot and stream it through base64 decoding, optional
+     * decompression and SHA-256 verification straight into a sink, without a
+     * full-size copy of the response. The sink may receive data before the
+     * checksum is known: discard what was written unless Success is true.
+     * @param saveId Save ID from ListSaves
+     * @param sink Receives raw save bytes; return false to abort
+     * @param codecHint Codec from ListSaves, used if the response lists it after the payload
+     */
+    SaveDownloadResult DownloadSave(
+        const std::string& titleToken,
+        const std::string& titleId,
+        const std::string& installId,
+        const std::string& saveId,
+        std::function<bool(const char* data, size_t size)> sink,
+        const std::string& codecHint = ""
+    );
+
+    /**
+     * DownloadSave into a file. Data is written to "<filePath>.part" and only
+     * renamed over filePath once the checksum has been verified.
+     */
+    SaveDownloadResult DownloadSaveToFile(
+        const std::string& titleToken,
+        const std::string& titleId,
+        const std::string& installId,
+        const std::string& saveId,
+        const std::string& filePath,
+        const std::string& codecHint = ""
+    );
+
+    /**
+     * One slot in a batch save transfer
+     */
+    struct SaveTransferItem
+    {
+        GameSaveData SaveData;          // Upload: save fields (SlotIndex, BaseVersion, ...)
+        std::string FilePath;           // Upload source / download target
+        std::string SaveId;             // Download: save ID from ListSaves
+        std::string CodecHint;          // Download: codec from ListSaves
+    };
+
+    /**
+     * Per-slot outcome and aggregate statistics of a batch transfer
+     */
+    struct SaveBatchResult
+    {
+        struct Item
+        {
+            int SlotIndex = 0;
+            bool Success = false;       // Uploads: answered 2xx; downloads: verified
+            bool Conflict = false;      // Upload rejected as a conflict (409); resolve it, don't just retry
+            long StatusCode = 0;        // Uploads: HTTP status, 0 if no response arrived
+            std::string Response;       // Server response or error
+            size_t Bytes = 0;           // Raw save bytes transferred
+        };
+
+        std::vector<Item> Items;        // Same order as the request
+        int Succeeded = 0;              // Succeeded + Conflicts + Failed == Items.size()
+        int Conflicts = 0;
+        int Failed = 0;
+        size_t TotalBytes = 0;          // Successful items only
+        double Seconds = 0.0;           // Wall-clock time of the whole batch
+        double ThroughputMBps = 0.0;    // TotalBytes / Seconds
+    };
+
+    /**
+     * Upload many save files concurrently (e.g. first login after reinstall).
+     * Each worker streams its file through hashing, compression and base64
+     * while uploading, so encoding overlaps with network time across slots.
+     * @param maxConcurrent Upper bound on simultaneous transfers
+     */
+    SaveBatchResult StoreSavesBatch(
+        const std::string& titleToken,
+        const std::string& titleId,
+        const std::string& installId,
+        const std::vector<SaveTransferItem>& items,
+        int maxConcurrent = 4
+    );
+
+    /**
+     * Download many save slots concurrently into their FilePath targets
+     * @param maxConcurrent Upper bound on simultaneous transfers
+     */
+    SaveBatchResult DownloadSavesBatch(
+        const std::string& titleToken,
+        const std::string& titleId,
+        const std::string& installId,
+        const std::vector<SaveTransferItem>& items,
+        int maxConcurrent = 4
+    );
+
+    /**
+     * Decode a payload returned by the API back into the raw save bytes
+     * @param payloadBase64 Payload as returned by the server
+     * @param codec Codec recorded with the save ("" for raw)
+     * @param raw Receives the decoded bytes
+     * @param checksum Optional: receives the SHA-256 (hex) of the decoded bytes
+     * @return false if the payload is corrupt or the codec is unavailable
+     */
+    bool DecodeSavePayload(
+        const std::string& payloadBase64,
+        const std::string& codec,
+        std::string& raw,
+        std::string* checksum = nullptr
+    );
+
     std::string ResolveSaveConflict(
         const std::string& titleToken, 
         const std::string& titleId, 
@@ -224,23 +1185,554 @@ namespace GlitchSDK
         const std::string& choice // "keep_server" or "use_client"
     );
 
+    /**
+     * Conflict reported by the server for an upload made by SaveSyncWorker
+     */
+    struct SaveConflict
+    {
+        int SlotIndex = 0;
+        std::string SaveId;             // Pass to ResolveSaveConflict
+        std::string ConflictId;         // Pass to ResolveSaveConflict
+        std::string Response;           // Raw StoreSave response
+    };
+
+    /**
+     * An upload the server refused for good (a 4xx other than a conflict, 408 or 429)
+     */
+    struct SaveRejection
+    {
+        int SlotIndex = 0;
+        long StatusCode = 0;
+        std::string Response;           // Raw StoreSave response
+    };
+
+    /**
+     * Background cloud-save uploader for one install.
+     * The game marks a slot dirty and hands over the save; a worker thread
+     * uploads only the newest version per slot (superseded versions are
+     * dropped unsent), tracks BaseVersion from server responses and reports
+     * conflicts through the conflict callback. Transport failures, 408, 429
+     * and 5xx are retried with backoff unless a newer version arrives first;
+     * other refusals are dropped and reported through the rejection callback.
+     */
+    class SaveSyncWorker
+    {
+    public:
+        SaveSyncWorker(const std::string& titleToken, const std::string& titleId, const std::string& installId);
+        ~SaveSyncWorker(); // Stops the worker and aborts its upload; pending slots are not uploaded, call Flush() first
+
+        SaveSyncWorker(const SaveSyncWorker&) = delete;
+        SaveSyncWorker& operator=(const SaveSyncWorker&) = delete;
+
+        /**
+         * Queue the latest state of a slot. BaseVersion is filled from the
+         * version tracked for the slot if the worker has seen one.
+         * @param saveData Save to upload; moved from, so pass with std::move
+         */
+        QueueResult MarkDirty(GameSaveData saveData);
+
+        /**
+         * Seed or override the tracked version for a slot (e.g. from ListSaves,
+         * or after ResolveSaveConflict). Also re-enables a slot paused by a conflict.
+         */
+        void SetBaseVersion(int slotIndex, int version);
+        int GetBaseVersion(int slotIndex) const;
+
+        /**
+         * Called on the worker thread when an upload is rejected as a conflict.
+         * The slot stays paused until SetBaseVersion is called for it.
+         */
+        void SetConflictCallback(std::function<void(const SaveConflict&)> callback);
+
+        /**
+         * Called on the worker thread when the server refuses an upload for good.
+         * The save is not retried; the next MarkDirty for the slot is sent as usual.
+         */
+        void SetRejectionCallback(std::function<void(const SaveRejection&)> callback);
+
+        /**
+         * Block until every dirty slot has been uploaded, paused or failed
+         */
+        void Flush();
+
+        /**
+         * Choose what MarkDirty does with saves whose MetadataJSON is invalid.
+         * Quarantined saves are recorded without their payload.
+         * @param quarantinePath JSON-lines file for MetadataPolicy::Quarantine; empty = only counted
+         */
+        void SetMetadataPolicy(MetadataPolicy policy, const std::string& quarantinePath = "");
+
+    private:
+        struct State;
+        std::unique_ptr<State> Impl;
+    };
+
     // --- 3. Behavioral Telemetry ---
 
     std::string RecordEvent(const std::string& titleToken, const std::string& titleId, const GameEventData& event);
 
     std::string RecordEventsBulk(const std::string& titleToken, const std::string& titleId, const std::vector<GameEventData>& events);
 
+    enum class EventOutcome
+    {
+        Accepted,
+        Retry,          // Transport failure, 408, 425, 429 or 5xx: worth sending again
+        Rejected        // Any other 4xx: the event itself is invalid
+    };
+
+    /**
+     * Per-event outcome of an /events/bulk request. The server reports items in
+     * request order under "results" ([{"status":201},{"status":422,"error":"..."}]).
+     * Without that array the batch status applies to every event.
+     */
+    struct BulkEventsResult
+    {
+        long StatusCode = 0;                    // Batch HTTP status; 0 on transport failure
+        std::string Response;                   // Response body, or "CURL error: ..."
+        std::vector<EventOutcome> Outcomes;     // One per event, in request order
+        std::vector<long> Statuses;             // Status per event; the batch status if none was given
+        std::vector<std::string> Errors;        // Server error per event, "" if none was given
+        std::chrono::seconds RetryAfter{0};     // Retry-After of the batch response; 0 if none
+        size_t Accepted = 0;
+        size_t Retryable = 0;
+        size_t Rejected = 0;
+    };
+
+    /**
+     * RecordEventsBulk that reports which events were accepted, so only the
+     * retryable ones need to be sent again
+     */
+    BulkEventsResult SendEventsBulk(const std::string& titleToken, const std::string& titleId, const std::vector<GameEventData>& events);
+
+    struct ClientConfig
+    {
+        std::string TitleToken;
+        std::string TitleId;
+        MetadataPolicy InvalidMetadata = MetadataPolicy::WrapAsString;
+        std::string QuarantinePath;         // JSON-lines file for MetadataPolicy::Quarantine; empty = only counted
+        size_t MaxBatchEvents = 500;        // Events per /events/bulk request
+        int FlushIntervalMs = 5000;         // Longest an event waits for its batch to fill
+        size_t MaxQueuedEvents = 100000;    // Beyond this the oldest events are dropped
+        int MaxEventAttempts = 5;           // Failed sends before a retryable event is dead-lettered; 429, 503 and no response don't count
+        int MaxPurchaseAttempts = 10;       // The same for a purchase, which holds up everything queued behind it
+        std::string DeadLetterPath;         // JSON-lines file for items the server will not take; empty = only counted
+        std::string SpoolPath;              // Items left over at Shutdown(), queued again by the next Client; empty = dropped
+        size_t ShutdownConcurrency = 4;     // Requests Shutdown() sends at once
+        size_t CrashRingEvents = 256;       // Newest unsent events kept for CrashFlush(), up to 1 KB each
+    };
+
+    /**
+     * What Client::Shutdown() did with the items it found
+     */
+    struct ShutdownReport
+    {
+        size_t PurchasesFlushed = 0;    // Accepted (2xx) before the deadline
+        size_t PurchasesRejected = 0;   // Refused with a non-retryable 4xx or out of attempts; dead-lettered, not spooled
+        size_t EventsFlushed = 0;       // Accepted by the server before the deadline
+        size_t EventsDeadLettered = 0;  // Rejected or out of attempts
+        size_t PurchasesSpilled = 0;    // Written to the spool for the next launch
+        size_t EventsSpilled = 0;
+        size_t Lost = 0;                // Left over with no SpoolPath, or the spool could not be written
+        bool DeadlineReached = false;   // The deadline cut the flush short
+    };
+
+    /**
+     * Asynchronous telemetry queue for one title. Queue calls validate the
+     * item's MetadataJSON on the calling thread, so a malformed item is dealt
+     * with by the configured policy and never reaches a batch. Events are sent
+     * in /events/bulk batches and purchases immediately, on the SDK's I/O threads.
+     * Only events the server reports as retryable are sent again, with backoff
+     * that honours the server's Retry-After; rejected events go to the
+     * dead-letter file. Throttling (429), 503 and outages leave events queued
+     * without using up their attempts, so only MaxQueuedEvents bounds them. A
+     * purchase that gets no response, 408, 429 or 5xx stays at the front of the
+     * queue until it has failed MaxPurchaseAttempts times (counted like events);
+     * refused or exhausted purchases go to the dead-letter file.
+     */
+    class Client
+    {
+    public:
+        explicit Client(const ClientConfig& config); // Queues whatever a previous run left in the spool
+        ~Client(); // Sends nothing further; call Flush() or Shutdown() first
+
+        Client(const Client&) = delete;
+        Client& operator=(const Client&) = delete;
+
+        QueueResult QueueEvent(GameEventData event);
+        QueueResult QueuePurchase(PurchaseData purchase);
+
+        /**
+         * Block until everything queued before the call has been sent or has failed
+         */
+        void Flush();
+
+        /**
+         * Send what is queued, purchases first, with up to ShutdownConcurrency
+         * requests at once, and return by the deadline. Whatever is not accepted
+         * by then, including a send still in flight, is written to the spool.
+         * The client queues nothing afterwards: QueueEvent and QueuePurchase return Rejected.
+         * @param deadline When to give up on the network; only the spool write follows
+         */
+        ShutdownReport Shutdown(std::chrono::steady_clock::time_point deadline);
+
+        /**
+         * Prepare for CrashFlush(): copy the newest CrashRingEvents unsent events into
+         * a preallocated ring as they are queued, and open SpoolPath now, so the crash
+         * path needs neither allocation nor open()
+         * @return false if SpoolPath is empty or cannot be opened
+         */
+        bool EnableCrashFlush();
+
+        /**
+         * Async-signal-safe: append the ring's unsent events to the spool using only
+         * write(), for the next Client to replay. Call from a crash handler; does
+         * nothing unless EnableCrashFlush() succeeded. Purchases are not covered.
+         */
+        void CrashFlush() const;
+
+        size_t GetQueuedCount() const;
+
+        struct State;
+
+    private:
+        std::shared_ptr<State> Impl; // Shared with scheduled sends so they can outlive the client
+    };
+
+    /**
+     * CrashFlush() every Client with crash flush enabled (up to 8).
+     * Async-signal-safe, for a process-wide signal or unhandled-exception handler.
+     */
+    void CrashFlushAll();
+
     // --- 4. Wishlist Intelligence (GWI) ---
 
     std::string ToggleWishlist(const std::string& userJwt, const std::string& titleId, const std::string& fingerprintId = "");
 
     std::string UpdateWishlistScore(const std::string& userJwt, const std::string& titleId, int score);
 
+    /**
+     * Debounced wishlist updates for store UIs and engagement scoring.
+     * Calls are recorded per (userJwt, titleId) and sent once the key has been
+     * quiet for the debounce window: an even number of toggles collapses to
+     * nothing, an odd number to one ToggleWishlist, and only the latest score
+     * is sent. At most one send per key is in flight; changes made during it
+     * are sent afterwards, and a score equal to the one just sent is dropped.
+     * Changes whose send fails with a transport error, 408, 425, 429 or 5xx
+     * are queued again and retried with backoff (2 s doubling to 60 s).
+     */
+    void QueueWishlistToggle(const std::string& userJwt, const std::string& titleId, const std::string& fingerprintId = "");
+
+    void QueueWishlistScore(const std::string& userJwt, const std::string& titleId, int score);
+
+    /**
+     * Set the quiet period before a queued wishlist change is sent
+     * @param milliseconds Debounce window (default: 2000)
+     */
+    void SetWishlistDebounce(int milliseconds);
+
+    /**
+     * Receive the responses of requests sent by the wishlist queue
+     * @param callback Called on the sending thread with titleId and response;
+     *                 failures that will be retried are not reported
+     */
+    void SetWishlistResultCallback(std::function<void(const std::string& titleId, const std::string& response)> callback);
+
+    /**
+     * Send all queued wishlist changes now, blocking until done (e.g. on shutdown).
+     * Each change is tried once even while backing off; what fails stays queued.
+     */
+    void FlushWishlistUpdates();
+
+    // --- 5. Metrics ---
+
+    /**
+     * Distribution of request durations. Buckets[i] counts observations above the
+     * previous bound and at or below LatencyBucketBounds[i] seconds; the last
+     * bucket has no upper bound.
+     */
+    struct LatencyHistogram
+    {
+        static const size_t BucketCount = 12;
+        uint64_t Buckets[BucketCount] = {};
+        uint64_t Count = 0;
+        double SumSeconds = 0.0;
+    };
+
+    extern const double LatencyBucketBounds[LatencyHistogram::BucketCount - 1]; // 5 ms ... 10 s
+
+    /**
+     * Point-in-time copy of the SDK's internal counters.
+     * All counters are cumulative since process start.
+     */
+    struct MetricsSnapshot
+    {
+        uint64_t ValidateCacheHits = 0;     // Served from the TTL cache
+        uint64_t ValidateCacheMisses = 0;   // Sent a request to /validate
+        uint64_t ValidateCoalesced = 0;     // Joined an identical in-flight request
+        uint64_t OfflineLicenseAccepted = 0;  // Startup served from a verified token
+        uint64_t OfflineLicenseRejected = 0;  // Token missing, expired or bad signature
+        uint64_t WishlistCallsQueued = 0;   // QueueWishlistToggle/Score calls
+        uint64_t WishlistRequestsSent = 0;  // Requests actually sent after coalescing
+        uint64_t SavesUploaded = 0;         // SaveSyncWorker uploads accepted by the server
+        uint64_t SavesSuperseded = 0;       // Dirty saves replaced before they were sent
+        uint64_t SaveConflicts = 0;         // Uploads rejected as conflicts
+        uint64_t SavesRejected = 0;         // SaveSyncWorker uploads refused with a non-retryable 4xx
+        uint64_t SavePartsSent = 0;         // Chunked upload parts acknowledged
+        uint64_t SavePartRetries = 0;       // Chunked upload parts sent more than once
+        uint64_t EventsQueued = 0;          // Client::QueueEvent calls accepted
+        uint64_t EventsDropped = 0;         // Oldest events dropped because the queue was full
+        uint64_t EventBatchesSent = 0;      // /events/bulk requests sent by Client
+        uint64_t EventsAccepted = 0;        // Events the server confirmed
+        uint64_t EventsRetried = 0;         // Events queued again after a retryable failure
+        uint64_t EventsDeadLettered = 0;    // Events rejected or out of attempts
+        uint64_t PurchasesDeadLettered = 0; // Purchases refused or out of attempts
+        uint64_t ItemsSpilled = 0;          // Events and purchases written to the spool at shutdown
+        uint64_t ItemsReplayed = 0;         // Spooled items queued again by a new Client
+        uint64_t MetadataWrapped = 0;       // Invalid MetadataJSON sent as a string
+        uint64_t MetadataQuarantined = 0;   // Items with invalid MetadataJSON written to the quarantine file
+        uint64_t MetadataRejected = 0;      // Items with invalid MetadataJSON refused
+        uint64_t RequestTimeouts = 0;       // Requests that hit their total, deadline or low-speed limit
+        uint64_t ConnectTimeouts = 0;       // Requests that could not connect in time
+        uint64_t RequestsCancelled = 0;     // Requests aborted through a CancellationToken
+
+        // Heap usage per subsystem. *Bytes is currently allocated, not cumulative.
+        uint64_t QueueBytes = 0;
+        uint64_t QueueAllocations = 0;
+        uint64_t SerializationBytes = 0;
+        uint64_t SerializationAllocations = 0;
+        uint64_t TransportBytes = 0;
+        uint64_t TransportAllocations = 0;
+        uint64_t SaveBytes = 0;
+        uint64_t SaveAllocations = 0;
+
+        LatencyHistogram RequestLatency[size_t(Endpoint::Count)]; // Transport time per endpoint group
+        LatencyHistogram RequestPhases[size_t(Endpoint::Count)][size_t(RequestPhase::Count)]; // From curl's timing
+
+        // Fraction of ValidateInstall calls that did not hit the network
+        double ValidateCacheHitRatio() const
+        {
+            uint64_t total = ValidateCacheHits + ValidateCacheMisses + ValidateCoalesced;
+            return total ? double(ValidateCacheHits + ValidateCoalesced) / double(total) : 0.0;
+        }
+    };
+
+    /**
+     * Read the current SDK metrics
+     * @return Snapshot of all counters
+     */
+    MetricsSnapshot GetMetrics();
+
+    /**
+     * Render metrics in the OpenMetrics text format (what Prometheus scrapes),
+     * ending with "# EOF"
+     */
+    std::string RenderOpenMetrics(const MetricsSnapshot& metrics);
+
+    struct MetricsExporterConfig
+    {
+        bool Listen = false;                    // Serve GET /metrics over HTTP
+        std::string BindAddress = "127.0.0.1";  // IPv4 address to listen on
+        int Port = 9464;                        // 0 picks a free port; see GetPort()
+        std::string FilePath;                   // Also rewrite this file on an interval (textfile collector); empty = off
+        int FileIntervalMs = 15000;
+    };
+
+    /**
+     * Optional OpenMetrics exporter for dedicated servers and relays. One
+     * background thread answers scrapes and rewrites the file; each scrape reads
+     * the same relaxed counters as GetMetrics(), so the hot paths never wait on it.
+     */
+    class MetricsExporter
+    {
+    public:
+        explicit MetricsExporter(const MetricsExporterConfig& config);
+        ~MetricsExporter(); // Stops the thread; the file gets one last write
+
+        MetricsExporter(const MetricsExporter&) = delete;
+        MetricsExporter& operator=(const MetricsExporter&) = delete;
+
+        bool IsListening() const;
+        int GetPort() const;    // Bound port, or 0 if not listening
+
+        struct State;
+
+    private:
+        std::unique_ptr<State> Impl;
+    };
+
     // Internal helper functions
     namespace Internal 
     {
         size_t WriteCallback(char* ptr, size_t size, size_t nmemb, void* userdata);
         std::string EscapeJSON(const std::string& input);
         std::string GetSystemInfo(const std::string& key);
+        // Atomically replaces "to" with "from"; the old file stays in place if this fails
+        bool RenameReplacing(const std::string& from, const std::string& to);
+        extern const char* const ApiBaseUrl; // "https://api.glitch.fun/api"
+        std::string Base64Encode(const unsigned char* data, size_t size);
+        size_t Base64EncodeTo(const unsigned char* data, size_t size, char* out); // out needs (size + 2) / 3 * 4 bytes
+        bool Base64Decode(const std::string& input, std::string& output); // Accepts base64 and base64url
+        // Value of the first "key" found at any depth, for flat API responses whose keys are
+        // unique; returns false if absent
+        bool ExtractJSONString(const std::string& json, const std::string& key, std::string& value);
+        bool ExtractJSONNumber(const std::string& json, const std::string& key, double& value);
+        // Raw JSON text of the member "key" of the top-level object only; returns false if absent
+        bool ExtractJSONField(const std::string& json, const std::string& key, std::string& value);
+        // Elements of the top-level array "key" as raw JSON text; returns false if absent
+        bool ExtractJSONArray(const std::string& json, const std::string& key, std::vector<std::string>& elements);
+
+        // LatencyHistogram as relaxed atomics; Observe never locks
+        struct HistogramCounters
+        {
+            std::atomic<uint64_t> Buckets[LatencyHistogram::BucketCount];
+            std::atomic<uint64_t> SumMicros;
+
+            void Observe(double seconds);
+            void Load(LatencyHistogram& histogram) const;
+        };
+
+        // Live counters behind GetMetrics(). Relaxed atomics only; never lock here.
+        struct MetricCounters
+        {
+            std::atomic<uint64_t> ValidateCacheHits;
+            std::atomic<uint64_t> ValidateCacheMisses;
+            std::atomic<uint64_t> ValidateCoalesced;
+            std::atomic<uint64_t> OfflineLicenseAccepted;
+            std::atomic<uint64_t> OfflineLicenseRejected;
+            std::atomic<uint64_t> WishlistCallsQueued;
+            std::atomic<uint64_t> WishlistRequestsSent;
+            std::atomic<uint64_t> SavesUploaded;
+            std::atomic<uint64_t> SavesSuperseded;
+            std::atomic<uint64_t> SaveConflicts;
+            std::atomic<uint64_t> SavesRejected;
+            std::atomic<uint64_t> SavePartsSent;
+            std::atomic<uint64_t> SavePartRetries;
+            std::atomic<uint64_t> EventsQueued;
+            std::atomic<uint64_t> EventsDropped;
+            std::atomic<uint64_t> EventBatchesSent;
+            std::atomic<uint64_t> EventsAccepted;
+            std::atomic<uint64_t> EventsRetried;
+            std::atomic<uint64_t> EventsDeadLettered;
+            std::atomic<uint64_t> PurchasesDeadLettered;
+            std::atomic<uint64_t> ItemsSpilled;
+            std::atomic<uint64_t> ItemsReplayed;
+            std::atomic<uint64_t> MetadataWrapped;
+            std::atomic<uint64_t> MetadataQuarantined;
+            std::atomic<uint64_t> MetadataRejected;
+            std::atomic<uint64_t> RequestTimeouts;
+            std::atomic<uint64_t> ConnectTimeouts;
+            std::atomic<uint64_t> RequestsCancelled;
+            HistogramCounters RequestLatency[size_t(Endpoint::Count)];
+            HistogramCounters RequestPhases[size_t(Endpoint::Count)][size_t(RequestPhase::Count)];
+            std::atomic<uint64_t> MemoryBytes[size_t(MemoryTag::Count)];
+            std::atomic<uint64_t> MemoryAllocations[size_t(MemoryTag::Count)];
+        };
+        MetricCounters& Counters();
+
+        // Apply the endpoint's TimeoutPolicy and the thread's RequestScope to request,
+        // send it through the active transport and count timeouts and cancellations
+        HttpResponse SendRequest(HttpRequest& request, Endpoint endpoint);
+
+        // True for statuses worth sending again: 0 (no response), 408, 425, 429 and 5xx
+        bool IsRetryableStatus(long status);
+
+        // Fill in a failure the transport detected itself ("CURL error: ..." like curl's own)
+        void SetRequestFailure(HttpResponse& response, RequestFailure failure);
+
+        // Accounted allocation from a specific host allocator
+        void* Allocate(IAllocator* allocator, size_t size, size_t alignment, MemoryTag tag);
+        void Deallocate(IAllocator* allocator, void* pointer, size_t size, MemoryTag tag);
+
+        // Standard allocator over the host allocator. Each container remembers the
+        // allocator it was created with, so SetAllocator never mixes heaps.
+        template <class T, MemoryTag Tag>
+        struct TaggedAllocator
+        {
+            typedef T value_type;
+            typedef std::true_type propagate_on_container_move_assignment;
+            typedef std::true_type propagate_on_container_swap;
+
+            TaggedAllocator() : Host(GetAllocator()) {}
+            template <class U> TaggedAllocator(const TaggedAllocator<U, Tag>& other) : Host(other.Host) {}
+            template <class U> struct rebind { typedef TaggedAllocator<U, Tag> other; };
+
+            T* allocate(size_t count)
+            {
+                void* pointer = Allocate(Host, count * sizeof(T), alignof(T), Tag);
+                if (!pointer) throw std::bad_alloc();
+                return (T*)pointer;
+            }
+            void deallocate(T* pointer, size_t count) { Deallocate(Host, pointer, count * sizeof(T), Tag); }
+
+            IAllocator* Host;
+        };
+
+        template <class T, class U, MemoryTag Tag>
+        bool operator==(const TaggedAllocator<T, Tag>& a, const TaggedAllocator<U, Tag>& b) { return a.Host == b.Host; }
+        template <class T, class U, MemoryTag Tag>
+        bool operator!=(const TaggedAllocator<T, Tag>& a, const TaggedAllocator<U, Tag>& b) { return a.Host != b.Host; }
+
+        template <MemoryTag Tag>
+        using TaggedString = std::basic_string<char, std::char_traits<char>, TaggedAllocator<char, Tag> >;
+        template <class T, MemoryTag Tag>
+        using TaggedVector = std::vector<T, TaggedAllocator<T, Tag> >;
+        template <class K, class V, MemoryTag Tag>
+        using TaggedMap = std::map<K, V, std::less<K>, TaggedAllocator<std::pair<const K, V>, Tag> >;
+
+        typedef std::basic_stringstream<char, std::char_traits<char>, TaggedAllocator<char, MemoryTag::Serialization> > JsonStream;
+        typedef TaggedString<MemoryTag::Serialization> JsonString;
+
+        // StoreSave request body
+        JsonString SaveJSON(const GameSaveData& saveData);
+
+        // EscapeJSON that appends in place instead of returning a new string
+        void AppendEscapedJSON(JsonString& out, const std::string& input);
+
+        // The object RecordEvent sends for event
+        void AppendEventJSON(JsonString& out, const GameEventData& event);
+
+        // Quoted JSON string holding raw: control characters escaped, invalid UTF-8 replaced by U+FFFD
+        std::string WrapAsJSONString(const std::string& raw);
+
+        /**
+         * Apply policy to metadata at enqueue time. Valid or empty metadata gives
+         * Queued; WrapAsString rewrites metadata in place. For Quarantined the
+         * caller writes the item with AppendQuarantine.
+         */
+        QueueResult CheckMetadata(std::string& metadata, MetadataPolicy policy, size_t* errorOffset);
+
+        // Append {"kind":..,"error_offset":..,"metadata_raw":..,"item":item} as one line to path
+        void AppendQuarantine(const std::string& path, const char* kind, size_t errorOffset,
+                              const std::string& rawMetadata, const JsonString& item);
+
+        // Append {"kind":..,"status":..,"error":..,"attempts":..,"item":item} as one line to path
+        void AppendDeadLetter(const std::string& path, const char* kind, long status, const std::string& error,
+                              int attempts, const JsonString& item);
+
+        // FingerprintToJSON(fingerprint), reused while the same components keep being sent
+        std::shared_ptr<const JsonString> CachedFingerprintJSON(const FingerprintComponents& fingerprint);
+
+        // SDK-owned pool for work that blocks on the network. The host's IExecutor only
+        // gets CPU work (serialization, compression, hashing).
+        std::shared_ptr<IExecutor> IoExecutor();
+        void SubmitIO(std::function<void()> task);
+
+        // SubmitIO once delay has passed. A single shared timer thread does the waiting;
+        // it never runs tasks itself.
+        void SubmitIOAfter(std::chrono::milliseconds delay, std::function<void()> task);
+
+        // Run task on the active executor and wait for it; rethrows what it throws.
+        // Call only from SDK-owned threads. If the executor drops the task, it runs on the caller.
+        void RunOnExecutor(const std::function<void()>& task);
+
+        // Run body(0..count-1) on up to maxConcurrent threads: the caller plus helpers on
+        // executor (the active one if null). Returns once every index is done, even if
+        // helpers never got to run. If body throws, the remaining indices are skipped and
+        // the first exception is rethrown on the caller.
+        void ParallelFor(size_t count, size_t maxConcurrent, const std::function<void(size_t)>& body,
+                         std::shared_ptr<IExecutor> executor = nullptr);
+
+        // How many threads ParallelFor can usefully keep busy on the active executor
+        size_t ExecutorConcurrency();
     }
 }
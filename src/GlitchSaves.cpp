@@ -0,0 +1,1293 @@
+#include "GlitchSDK.h"
+#include <openssl/evp.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+// zstd is optional: build with GLITCH_WITH_ZSTD=1 and link libzstd to enable save compression
+#ifndef GLITCH_WITH_ZSTD
+    #define GLITCH_WITH_ZSTD 0
+#endif
+
+#if GLITCH_WITH_ZSTD
+    #include <zstd.h>
+#endif
+
+namespace GlitchSDK
+{
+    // --- Save payload codec ---
+    //
+    // Payloads flow through small streaming stages so no stage needs a full-size
+    // intermediate buffer:
+    //   upload:   raw -> SHA-256 -> [zstd + dictionary] -> base64 -> sink
+    //   download: base64 -> [zstd + dictionary] -> SHA-256 -> sink
+
+    namespace
+    {
+        typedef std::function<bool(const char* data, size_t size)> ChunkSink;
+
+        const size_t kStreamChunk = 64 * 1024;
+
+        // Scratch buffers for payload encoding, accounted under MemoryTag::Saves
+        typedef Internal::TaggedString<MemoryTag::Saves> SaveBuffer;
+
+        class Sha256
+        {
+        public:
+            Sha256() : Ctx(EVP_MD_CTX_new()) { EVP_DigestInit_ex(Ctx, EVP_sha256(), NULL); }
+            ~Sha256() { EVP_MD_CTX_free(Ctx); }
+            Sha256(const Sha256&) = delete;
+            Sha256& operator=(const Sha256&) = delete;
+
+            void Update(const void* data, size_t size) { EVP_DigestUpdate(Ctx, data, size); }
+            void Reset() { EVP_DigestInit_ex(Ctx, EVP_sha256(), NULL); }
+
+            std::string HexDigest()
+            {
+                unsigned char digest[EVP_MAX_MD_SIZE];
+                unsigned int length = 0;
+                EVP_DigestFinal_ex(Ctx, digest, &length);
+                static const char hex[] = "0123456789abcdef";
+                std::string out;
+                for (unsigned int i = 0; i < length; ++i) {
+                    out += hex[digest[i] >> 4];
+                    out += hex[digest[i] & 15];
+                }
+                return out;
+            }
+
+        private:
+            EVP_MD_CTX* Ctx;
+        };
+
+        // Streaming base64 encoder; carries up to two bytes between writes
+        class Base64Writer
+        {
+        public:
+            explicit Base64Writer(const ChunkSink& sink) : Sink(sink) {}
+
+            bool Write(const unsigned char* data, size_t size)
+            {
+                while (size > 0) {
+                    if (PendingSize > 0 || size < 3) {
+                        while (PendingSize < 3 && size > 0) {
+                            Pending[PendingSize++] = *data++;
+                            --size;
+                        }
+                        if (PendingSize < 3) return true;
+                        Append(Pending, 3);
+                        PendingSize = 0;
+                        continue;
+                    }
+                    size_t whole = std::min(size - size % 3, kStreamChunk / 4 * 3);
+                    Append(data, whole);
+                    data += whole;
+                    size -= whole;
+                    if (Out.size() >= kStreamChunk && !Drain()) return false;
+                }
+                return true;
+            }
+
+            bool Finish()
+            {
+                if (PendingSize > 0) Append(Pending, PendingSize);
+                PendingSize = 0;
+                return Drain();
+            }
+
+            void Reset()
+            {
+                Out.clear();
+                PendingSize = 0;
+            }
+
+        private:
+            void Append(const unsigned char* data, size_t size)
+            {
+                size_t at = Out.size();
+                Out.resize(at + (size + 2) / 3 * 4);
+                Internal::Base64EncodeTo(data, size, &Out[at]);
+            }
+
+            bool Drain()
+            {
+                bool ok = Out.empty() || Sink(Out.data(), Out.size());
+                Out.clear();
+                return ok;
+            }
+
+            ChunkSink Sink;
+            SaveBuffer Out;
+            unsigned char Pending[3];
+            size_t PendingSize = 0;
+        };
+
+        // Streaming base64 decoder; accepts arbitrary chunk boundaries
+        class Base64Reader
+        {
+        public:
+            explicit Base64Reader(const ChunkSink& sink) : Sink(sink) {}
+
+            bool Write(const char* text, size_t size)
+            {
+                for (size_t i = 0; i < size; ++i) {
+                    char c = text[i];
+                    int v;
+                    if (c >= 'A' && c <= 'Z') v = c - 'A';
+                    else if (c >= 'a' && c <= 'z') v = c - 'a' + 26;
+                    else if (c >= '0' && c <= '9') v = c - '0' + 52;
+                    else if (c == '+' || c == '-') v = 62;
+                    else if (c == '/' || c == '_') v = 63;
+                    else if (c == '=' || c == '\n' || c == '\r') continue;
+                    else if (c == '\\') continue; // JSON may escape '/' as "\/"
+                    else return false;
+                    Bits = (Bits << 6) | uint32_t(v);
+                    BitCount += 6;
+                    if (BitCount >= 8) {
+                        BitCount -= 8;
+                        Out += char((Bits >> BitCount) & 0xFF);
+                    }
+                }
+                if (Out.size() >= kStreamChunk) return Drain();
+                return true;
+            }
+
+            bool Finish() { return Drain(); }
+
+        private:
+            bool Drain()
+            {
+                bool ok = Out.empty() || Sink(Out.data(), Out.size());
+                Out.clear();
+                return ok;
+            }
+
+            ChunkSink Sink;
+            SaveBuffer Out;
+            uint32_t Bits = 0;
+            int BitCount = 0;
+        };
+
+#if GLITCH_WITH_ZSTD
+        struct SaveDictionary
+        {
+            std::shared_ptr<ZSTD_CDict> Compress;
+            std::shared_ptr<ZSTD_DDict> Decompress;
+            unsigned DictId = 0;
+        };
+
+        std::mutex g_dictionaryMutex;
+        SaveDictionary g_dictionary;
+
+        SaveDictionary CurrentDictionary()
+        {
+            std::lock_guard<std::mutex> lock(g_dictionaryMutex);
+            return g_dictionary;
+        }
+
+        std::string CodecName(unsigned dictId)
+        {
+            std::stringstream ss;
+            ss << "zstd-dict:" << dictId;
+            return ss.str();
+        }
+#endif
+
+        // raw -> [zstd] -> base64 -> sink. Hashes the raw bytes on the way through.
+        class SavePayloadEncoder
+        {
+        public:
+            explicit SavePayloadEncoder(const ChunkSink& sink) : Encoder(sink)
+            {
+#if GLITCH_WITH_ZSTD
+                Dictionary = CurrentDictionary();
+                if (Dictionary.Compress) {
+                    Cctx = ZSTD_createCCtx();
+                    ZSTD_CCtx_refCDict(Cctx, Dictionary.Compress.get());
+                    Buffer.resize(ZSTD_CStreamOutSize());
+                }
+#endif
+            }
+
+            ~SavePayloadEncoder()
+            {
+#if GLITCH_WITH_ZSTD
+                if (Cctx) ZSTD_freeCCtx(Cctx);
+#endif
+            }
+
+            SavePayloadEncoder(const SavePayloadEncoder&) = delete;
+            SavePayloadEncoder& operator=(const SavePayloadEncoder&) = delete;
+
+            // Optional: lets zstd size its window and record the content size
+            void SetSourceSize(size_t size)
+            {
+#if GLITCH_WITH_ZSTD
+                if (Cctx) ZSTD_CCtx_setPledgedSrcSize(Cctx, size);
+#else
+                (void)size;
+#endif
+            }
+
+            bool Write(const void* data, size_t size)
+            {
+                Hash.Update(data, size);
+#if GLITCH_WITH_ZSTD
+                if (Cctx) return Compress(data, size, ZSTD_e_continue);
+#endif
+                return Encoder.Write((const unsigned char*)data, size);
+            }
+
+            bool Finish()
+            {
+#if GLITCH_WITH_ZSTD
+                if (Cctx && !Compress(NULL, 0, ZSTD_e_end)) return false;
+#endif
+                Checksum = Hash.HexDigest();
+                return Encoder.Finish();
+            }
+
+            const std::string& GetChecksum() const { return Checksum; }
+
+            // Start a new payload with the same codec; call SetSourceSize again afterwards
+            void Reset()
+            {
+#if GLITCH_WITH_ZSTD
+                if (Cctx) ZSTD_CCtx_reset(Cctx, ZSTD_reset_session_only);
+#endif
+                Encoder.Reset();
+                Hash.Reset();
+                Checksum.clear();
+            }
+
+            std::string GetCodec() const
+            {
+#if GLITCH_WITH_ZSTD
+                if (Cctx) return CodecName(Dictionary.DictId);
+#endif
+                return std::string();
+            }
+
+        private:
+#if GLITCH_WITH_ZSTD
+            bool Compress(const void* data, size_t size, ZSTD_EndDirective mode)
+            {
+                ZSTD_inBuffer in = { data, size, 0 };
+                for (;;) {
+                    ZSTD_outBuffer out = { &Buffer[0], Buffer.size(), 0 };
+                    size_t remaining = ZSTD_compressStream2(Cctx, &out, &in, mode);
+                    if (ZSTD_isError(remaining)) return false;
+                    if (out.pos > 0 && !Encoder.Write((const unsigned char*)Buffer.data(), out.pos)) return false;
+                    bool done = (mode == ZSTD_e_end) ? remaining == 0 : in.pos == in.size;
+                    if (done) return true;
+                }
+            }
+
+            SaveDictionary Dictionary;
+            ZSTD_CCtx* Cctx = nullptr;
+            SaveBuffer Buffer;
+#endif
+            Base64Writer Encoder;
+            Sha256 Hash;
+            std::string Checksum;
+        };
+
+        // base64 -> [zstd] -> sink. Hashes the decoded raw bytes.
+        class SavePayloadDecoder
+        {
+        public:
+            SavePayloadDecoder(const ChunkSink& sink, const std::string& codec)
+                : Sink(sink), Decoder(std::bind(&SavePayloadDecoder::OnDecoded, this, std::placeholders::_1, std::placeholders::_2))
+            {
+                Valid = codec.empty();
+#if GLITCH_WITH_ZSTD
+                if (codec.compare(0, 5, "zstd-") == 0) {
+                    SaveDictionary dictionary = CurrentDictionary();
+                    if (dictionary.Decompress && codec == CodecName(dictionary.DictId)) {
+                        Dictionary = dictionary;
+                        Dctx = ZSTD_createDCtx();
+                        ZSTD_DCtx_refDDict(Dctx, Dictionary.Decompress.get());
+                        Buffer.resize(ZSTD_DStreamOutSize());
+                        Valid = true;
+                    }
+                }
+#endif
+            }
+
+            ~SavePayloadDecoder()
+            {
+#if GLITCH_WITH_ZSTD
+                if (Dctx) ZSTD_freeDCtx(Dctx);
+#endif
+            }
+
+            SavePayloadDecoder(const SavePayloadDecoder&) = delete;
+            SavePayloadDecoder& operator=(const SavePayloadDecoder&) = delete;
+
+            // False when the codec is unknown or needs a dictionary that is not loaded
+            bool IsValid() const { return Valid; }
+
+            bool Write(const char* text, size_t size) { return Valid && Decoder.Write(text, size); }
+
+            bool Finish()
+            {
+                if (!Valid || !Decoder.Finish()) return false;
+                Checksum = Hash.HexDigest();
+#if GLITCH_WITH_ZSTD
+                if (Dctx && !FrameComplete) return false;
+#endif
+                return true;
+            }
+
+            const std::string& GetChecksum() const { return Checksum; }
+
+        private:
+            bool OnDecoded(const char* data, size_t size)
+            {
+#if GLITCH_WITH_ZSTD
+                if (Dctx) {
+                    ZSTD_inBuffer in = { data, size, 0 };
+                    while (in.pos < in.size) {
+                        ZSTD_outBuffer out = { &Buffer[0], Buffer.size(), 0 };
+                        size_t hint = ZSTD_decompressStream(Dctx, &out, &in);
+                        if (ZSTD_isError(hint)) return false;
+                        FrameComplete = hint == 0;
+                        if (out.pos > 0 && !Emit(Buffer.data(), out.pos)) return false;
+                    }
+                    return true;
+                }
+#endif
+                return Emit(data, size);
+            }
+
+            bool Emit(const char* data, size_t size)
+            {
+                Hash.Update(data, size);
+                return Sink(data, size);
+            }
+
+            ChunkSink Sink;
+            Base64Reader Decoder;
+            Sha256 Hash;
+            std::string Checksum;
+            bool Valid = false;
+#if GLITCH_WITH_ZSTD
+            SaveDictionary Dictionary;
+            ZSTD_DCtx* Dctx = nullptr;
+            SaveBuffer Buffer;
+            bool FrameComplete = false;
+#endif
+        };
+
+        // JSON fields of a save record other than payload and checksum
+        template <class Body>
+        void AppendSaveFields(Body& body, const GameSaveData& saveData, const std::string& codec)
+        {
+            std::stringstream json;
+            json << R"("slot_index":)" << saveData.SlotIndex << ","
+                 << R"("base_version":)" << saveData.BaseVersion << ","
+                 << R"("save_type":")" << saveData.SaveType << R"(",)"
+                 << R"("client_timestamp":")" << saveData.ClientTimestamp << R"(")";
+            if (!codec.empty()) json << R"(,"codec":")" << Internal::EscapeJSON(codec) << R"(")";
+            if (!saveData.MetadataJSON.empty()) json << R"(,"metadata":)" << saveData.MetadataJSON;
+            const std::string fields = json.str();
+            body.append(fields.data(), fields.size());
+        }
+    }
+
+    namespace
+    {
+        // Read-only view of a whole file
+        class MappedFile
+        {
+        public:
+            MappedFile() {}
+            ~MappedFile() { Close(); }
+            MappedFile(const MappedFile&) = delete;
+            MappedFile& operator=(const MappedFile&) = delete;
+
+            bool Open(const std::string& path)
+            {
+#ifdef _WIN32
+                File = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                                   FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+                if (File == INVALID_HANDLE_VALUE) return false;
+                LARGE_INTEGER fileSize;
+                if (!GetFileSizeEx(File, &fileSize)) return false;
+                Size = size_t(fileSize.QuadPart);
+                if (Size == 0) return true;
+                Mapping = CreateFileMappingA(File, NULL, PAGE_READONLY, 0, 0, NULL);
+                if (!Mapping) return false;
+                Data = (const unsigned char*)MapViewOfFile(Mapping, FILE_MAP_READ, 0, 0, 0);
+                return Data != NULL;
+#else
+                int fd = open(path.c_str(), O_RDONLY);
+                if (fd < 0) return false;
+                struct stat info;
+                if (fstat(fd, &info) != 0) {
+                    close(fd);
+                    return false;
+                }
+                Size = size_t(info.st_size);
+                if (Size == 0) {
+                    close(fd);
+                    return true;
+                }
+                void* view = mmap(NULL, Size, PROT_READ, MAP_PRIVATE, fd, 0);
+                close(fd); // The mapping keeps the file referenced
+                if (view == MAP_FAILED) return false;
+                madvise(view, Size, MADV_SEQUENTIAL);
+                Data = (const unsigned char*)view;
+                return true;
+#endif
+            }
+
+            void Close()
+            {
+#ifdef _WIN32
+                if (Data) UnmapViewOfFile(Data);
+                if (Mapping) CloseHandle(Mapping);
+                if (File != INVALID_HANDLE_VALUE) CloseHandle(File);
+                Mapping = NULL;
+                File = INVALID_HANDLE_VALUE;
+#else
+                if (Data) munmap((void*)Data, Size);
+#endif
+                Data = nullptr;
+                Size = 0;
+            }
+
+            const unsigned char* GetData() const { return Data; }
+            size_t GetSize() const { return Size; }
+
+        private:
+            const unsigned char* Data = nullptr;
+            size_t Size = 0;
+#ifdef _WIN32
+            HANDLE File = INVALID_HANDLE_VALUE;
+            HANDLE Mapping = NULL;
+#endif
+        };
+
+        // Produces {"payload":"...","checksum":"...",<fields>} on demand for HttpRequest::BodyReader.
+        // Only one encoded chunk is buffered at a time.
+        class StreamingSaveBody
+        {
+        public:
+            StreamingSaveBody(const GameSaveData& saveData, const unsigned char* data, size_t size)
+                : SaveData(saveData), Input(data), InputSize(size),
+                  Encoder([this](const char* chunk, size_t length) { Buffer.append(chunk, length); return true; })
+            {
+                Encoder.SetSourceSize(size);
+                Buffer = R"({"payload":")";
+            }
+
+            // HttpRequest::BodyRewind: encode the payload again from the start
+            bool Rewind()
+            {
+                Encoder.Reset();
+                Encoder.SetSourceSize(InputSize);
+                Buffer = R"({"payload":")";
+                Offset = 0;
+                Position = 0;
+                Finished = false;
+                return true;
+            }
+
+            // Exact body size when it can be known up front (uncompressed payloads), otherwise -1
+            long long ContentLength() const
+            {
+                if (!Encoder.GetCodec().empty()) return -1;
+                std::string tail;
+                AppendSaveFields(tail, SaveData, std::string());
+                return (long long)(std::string(R"({"payload":")").size() + (InputSize + 2) / 3 * 4 +
+                                   std::string(R"(","checksum":")").size() + 64 + 2 + tail.size() + 1);
+            }
+
+            size_t Read(char* buffer, size_t capacity)
+            {
+                while (Offset == Buffer.size()) {
+                    if (Finished) return 0;
+                    Buffer.clear();
+                    Offset = 0;
+                    if (Position < InputSize) {
+                        size_t length = std::min(InputSize - Position, kStreamChunk / 4 * 3);
+                        if (!Encoder.Write(Input + Position, length)) return CURL_READFUNC_ABORT;
+                        Position += length;
+                    } else {
+                        if (!Encoder.Finish()) return CURL_READFUNC_ABORT;
+                        Buffer += R"(","checksum":")";
+                        Buffer.append(Encoder.GetChecksum().data(), Encoder.GetChecksum().size());
+                        Buffer += R"(",)";
+                        AppendSaveFields(Buffer, SaveData, Encoder.GetCodec());
+                        Buffer += "}";
+                        Finished = true;
+                    }
+                }
+                size_t length = std::min(capacity, Buffer.size() - Offset);
+                memcpy(buffer, Buffer.data() + Offset, length);
+                Offset += length;
+                return length;
+            }
+
+        private:
+            const GameSaveData& SaveData;
+            const unsigned char* Input;
+            size_t InputSize;
+            size_t Position = 0;
+            SaveBuffer Buffer;
+            size_t Offset = 0;
+            bool Finished = false;
+            SavePayloadEncoder Encoder;
+        };
+    }
+
+    namespace
+    {
+        // HttpRequest::ResponseSink for DownloadSave. Scans the JSON response as it
+        // arrives: the "payload" string is fed to a SavePayloadDecoder chunk by chunk,
+        // everything else is kept in Envelope for the small metadata fields.
+        class StreamingSaveResponse
+        {
+        public:
+            StreamingSaveResponse(const ChunkSink& sink, const std::string& codecHint)
+                : Sink(sink), CodecHint(codecHint) {}
+
+            // The transport only delivers 2xx bodies here
+            bool Write(const char* data, size_t size)
+            {
+                size_t i = 0;
+                while (i < size) {
+                    if (State == Mode::Payload) {
+                        // Hand the run of payload characters to the decoder in one call
+                        size_t start = i;
+                        while (i < size && !(data[i] == '"' && !Escaped)) {
+                            Escaped = !Escaped && data[i] == '\\';
+                            ++i;
+                        }
+                        if (i > start && !Decoder->Write(data + start, i - start)) return false;
+                        if (i < size) {
+                            Envelope += "\"\"";
+                            State = Mode::Envelope;
+                            ++i;
+                        }
+                        continue;
+                    }
+
+                    char c = data[i++];
+                    if (State == Mode::AwaitPayload) {
+                        if (c == '"') {
+                            StartPayload();
+                            State = Mode::Payload;
+                            continue;
+                        }
+                        if (c != ' ' && c != '\t' && c != '\r' && c != '\n') State = Mode::Envelope; // Not a string
+                    }
+
+                    Envelope += c;
+                    if (InString) {
+                        if (Escaped) Escaped = false;
+                        else if (c == '\\') Escaped = true;
+                        else if (c == '"') InString = false;
+                        else if (LastString.size() < 16) LastString += c;
+                    } else if (c == '"') {
+                        InString = true;
+                        LastString.clear();
+                    } else if (c == ':' && LastString == "payload" && !Decoder) {
+                        State = Mode::AwaitPayload;
+                    } else if (c != ' ' && c != '\t' && c != '\r' && c != '\n') {
+                        LastString.clear();
+                    }
+                }
+                return true;
+            }
+
+            void Complete(SaveDownloadResult& result)
+            {
+                result.Response = Envelope;
+                Internal::ExtractJSONString(Envelope, "codec", result.Codec);
+                double version = 0;
+                if (Internal::ExtractJSONNumber(Envelope, "version", version)) result.Version = int(version);
+
+                if (!Decoder) {
+                    result.Error = "Response has no payload";
+                    return;
+                }
+                if (!Decoder->Finish()) {
+                    result.Error = "Corrupt payload or unsupported codec";
+                    return;
+                }
+                if (result.Codec != UsedCodec) {
+                    result.Error = "Codec mismatch: payload decoded as '" + UsedCodec + "' but stored as '" + result.Codec + "'";
+                    return;
+                }
+
+                std::string expected;
+                result.Checksum = Decoder->GetChecksum();
+                result.Bytes = Bytes;
+                Internal::ExtractJSONString(Envelope, "checksum", expected);
+                if (expected.empty() || expected != result.Checksum) {
+                    result.Error = "Checksum mismatch";
+                    return;
+                }
+                result.Success = true;
+            }
+
+        private:
+            enum class Mode { Envelope, AwaitPayload, Payload };
+
+            void StartPayload()
+            {
+                // Fields sent before the payload win over the caller's hint
+                UsedCodec = CodecHint;
+                Internal::ExtractJSONString(Envelope, "codec", UsedCodec);
+                Decoder.reset(new SavePayloadDecoder([this](const char* chunk, size_t length) {
+                    Bytes += length;
+                    return Sink(chunk, length);
+                }, UsedCodec));
+                Escaped = false;
+            }
+
+            ChunkSink Sink;
+            std::string CodecHint;
+            std::string UsedCodec;
+            std::unique_ptr<SavePayloadDecoder> Decoder;
+            std::string Envelope;
+            std::string LastString;
+            Mode State = Mode::Envelope;
+            bool InString = false;
+            bool Escaped = false;
+            size_t Bytes = 0;
+        };
+    }
+
+    namespace
+    {
+        // One blocking request for the chunked upload protocol. Returns the HTTP status,
+        // or 0 with an error string in response on transport failure.
+        long SendUploadRequest(const char* method, const std::string& url, const TitleContext& context,
+                               const char* contentType, const char* body, size_t bodySize, const std::string& extraHeader,
+                               std::string& response)
+        {
+            // Per-part headers vary, so this list is built per request on top of the context's auth line
+            struct curl_slist *headers = NULL;
+            headers = curl_slist_append(headers, context.AuthorizationHeader().c_str());
+            if (contentType) headers = curl_slist_append(headers, contentType);
+            if (!extraHeader.empty()) headers = curl_slist_append(headers, extraHeader.c_str());
+
+            HttpRequest request;
+            request.Method = method;
+            request.Url = url;
+            request.Headers = headers;
+            if (strcmp(method, "GET") != 0) request.SetBody(body, bodySize);
+
+            HttpResponse reply = Internal::SendRequest(request, Endpoint::Saves);
+            curl_slist_free_all(headers);
+            response = reply.Error.empty() ? reply.Body : reply.Error;
+            return reply.StatusCode;
+        }
+    }
+
+    bool SetSaveCompressionDictionary(const std::string& dictionary, int level)
+    {
+#if GLITCH_WITH_ZSTD
+        unsigned dictId = ZSTD_getDictID_fromDict(dictionary.data(), dictionary.size());
+        ZSTD_CDict* cdict = ZSTD_createCDict(dictionary.data(), dictionary.size(), level);
+        ZSTD_DDict* ddict = ZSTD_createDDict(dictionary.data(), dictionary.size());
+        if (!cdict || !ddict || dictId == 0) {
+            ZSTD_freeCDict(cdict);
+            ZSTD_freeDDict(ddict);
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(g_dictionaryMutex);
+        g_dictionary.Compress = std::shared_ptr<ZSTD_CDict>(cdict, ZSTD_freeCDict);
+        g_dictionary.Decompress = std::shared_ptr<ZSTD_DDict>(ddict, ZSTD_freeDDict);
+        g_dictionary.DictId = dictId;
+        return true;
+#else
+        (void)dictionary;
+        (void)level;
+        return false;
+#endif
+    }
+
+    std::string StoreSaveRaw(const std::string& titleToken, const std::string& titleId, const std::string& installId,
+                             const GameSaveData& saveData, const void* data, size_t size)
+    {
+        std::shared_ptr<const TitleContext> context = TitleContext::Get(titleToken, titleId);
+
+        // The encoder appends straight into the request body, so the only full-size
+        // buffer is the body itself
+        SaveBuffer jsonBody;
+        jsonBody.reserve(size * 4 / 3 + 512);
+        jsonBody += R"({"payload":")";
+        SavePayloadEncoder encoder([&jsonBody](const char* chunk, size_t length) {
+            jsonBody.append(chunk, length);
+            return true;
+        });
+        encoder.SetSourceSize(size);
+        encoder.Write(data, size);
+        encoder.Finish();
+        jsonBody += R"(","checksum":")";
+        jsonBody.append(encoder.GetChecksum().data(), encoder.GetChecksum().size());
+        jsonBody += R"(",)";
+        AppendSaveFields(jsonBody, saveData, encoder.GetCodec());
+        jsonBody += "}";
+
+        return context->Send(context->InstallUrl(installId, "/saves"), jsonBody.data(), jsonBody.size());
+    }
+
+    namespace
+    {
+        std::string StoreSaveFile(const std::string& titleToken, const std::string& titleId, const std::string& installId,
+                                  const GameSaveData& saveData, const std::string& filePath, long* status)
+        {
+            MappedFile file;
+            if (!file.Open(filePath)) return "Failed to map save file: " + filePath;
+
+            std::shared_ptr<const TitleContext> context = TitleContext::Get(titleToken, titleId);
+            StreamingSaveBody body(saveData, file.GetData(), file.GetSize());
+
+            HttpRequest request;
+            request.Method = "POST";
+            request.Url = context->InstallUrl(installId, "/saves");
+            request.Headers = context->JsonHeaders();
+            request.BodyReader = [&body](char* buffer, size_t size) { return body.Read(buffer, size); };
+            request.BodyRewind = [&body]() { return body.Rewind(); };
+            request.BodySize = body.ContentLength();
+
+            HttpResponse response = Internal::SendRequest(request, Endpoint::Saves);
+            if (status) *status = response.StatusCode;
+            return response.Error.empty() ? response.Body : response.Error;
+        }
+    }
+
+    std::string StoreSaveFromFile(const std::string& titleToken, const std::string& titleId, const std::string& installId,
+                                  const GameSaveData& saveData, const std::string& filePath)
+    {
+        return StoreSaveFile(titleToken, titleId, installId, saveData, filePath, nullptr);
+    }
+
+    SaveDownloadResult DownloadSave(const std::string& titleToken, const std::string& titleId, const std::string& installId,
+                                    const std::string& saveId, std::function<bool(const char* data, size_t size)> sink,
+                                    const std::string& codecHint)
+    {
+        SaveDownloadResult result;
+        std::shared_ptr<const TitleContext> context = TitleContext::Get(titleToken, titleId);
+        StreamingSaveResponse stream(sink, codecHint);
+
+        HttpRequest request;
+        request.Url = context->InstallUrl(installId, "/saves/") + saveId;
+        request.Headers = context->AuthHeaders();
+        request.ResponseSink = [&stream](const char* data, size_t size) { return stream.Write(data, size); };
+
+        HttpResponse response = Internal::SendRequest(request, Endpoint::Saves);
+        result.StatusCode = response.StatusCode;
+        if (!response.Error.empty()) {
+            result.Error = response.Error;
+        } else if (response.StatusCode >= 300) {
+            result.Response = response.Body;
+            result.Error = "HTTP " + std::to_string(response.StatusCode);
+        } else {
+            stream.Complete(result);
+        }
+        return result;
+    }
+
+    SaveDownloadResult DownloadSaveToFile(const std::string& titleToken, const std::string& titleId, const std::string& installId,
+                                          const std::string& saveId, const std::string& filePath, const std::string& codecHint)
+    {
+        std::string partPath = filePath + ".part";
+        SaveDownloadResult result;
+        {
+            std::ofstream file(partPath.c_str(), std::ios::binary | std::ios::trunc);
+            if (!file.is_open()) {
+                result.Error = "Failed to open " + partPath;
+                return result;
+            }
+            result = DownloadSave(titleToken, titleId, installId, saveId, [&file](const char* data, size_t size) {
+                file.write(data, std::streamsize(size));
+                return file.good();
+            }, codecHint);
+            file.close();
+            if (result.Success && file.fail()) {
+                result.Success = false;
+                result.Error = "Failed to write " + partPath;
+            }
+        }
+
+        if (!result.Success) {
+            std::remove(partPath.c_str());
+            return result;
+        }
+        if (!Internal::RenameReplacing(partPath, filePath)) {
+            std::remove(partPath.c_str());
+            result.Success = false;
+            result.Error = "Failed to replace " + filePath;
+        }
+        return result;
+    }
+
+    std::string StoreSaveChunked(const std::string& titleToken, const std::string& titleId, const std::string& installId,
+                                 const GameSaveData& saveData, const std::string& filePath, SaveUploadSession& session,
+                                 int maxRetriesPerPart)
+    {
+        MappedFile file;
+        if (!file.Open(filePath)) return "Failed to map save file: " + filePath;
+
+        std::shared_ptr<const TitleContext> context = TitleContext::Get(titleToken, titleId);
+        std::string uploadsUrl = context->InstallUrl(installId, "/saves/uploads");
+        std::string response;
+        if (session.PartSize == 0) session.PartSize = SaveUploadSession().PartSize;
+
+        SavePayloadEncoder probe([](const char*, size_t) { return true; });
+        std::string codec = probe.GetCodec();
+        Sha256 sourceHash;
+        sourceHash.Update(file.GetData(), file.GetSize());
+        std::string sourceChecksum = sourceHash.HexDigest();
+
+        // Skipped parts are re-encoded, not re-sent, so only resume for the same bytes and codec
+        if (session.SourceSize != file.GetSize() || session.SourceChecksum != sourceChecksum || session.Codec != codec) {
+            session.UploadId.clear();
+        }
+
+        // Resume: ask the server how far it got. An unknown session starts over.
+        size_t resumeFrom = 0;
+        if (!session.UploadId.empty()) {
+            long status = SendUploadRequest("GET", uploadsUrl + "/" + session.UploadId, *context, NULL, NULL, 0, "", response);
+            if (status == 0) return response;
+            double nextPart = 0;
+            if (status < 400 && Internal::ExtractJSONNumber(response, "next_part", nextPart)) {
+                resumeFrom = size_t(nextPart);
+                double partSize = 0;
+                if (Internal::ExtractJSONNumber(response, "part_size", partSize) && partSize > 0) session.PartSize = size_t(partSize);
+            } else {
+                session.UploadId.clear();
+            }
+        }
+
+        if (session.UploadId.empty()) {
+            std::string body = "{";
+            AppendSaveFields(body, saveData, codec);
+            body += R"(,"part_size":)" + std::to_string(session.PartSize) + "}";
+            long status = SendUploadRequest("POST", uploadsUrl, *context, "Content-Type: application/json", body.data(), body.size(), "", response);
+            if (status == 0 || status >= 400) return response;
+            double partSize = 0;
+            if (!Internal::ExtractJSONString(response, "upload_id", session.UploadId)) return response;
+            if (Internal::ExtractJSONNumber(response, "part_size", partSize) && partSize > 0) session.PartSize = size_t(partSize);
+            session.SourceSize = file.GetSize();
+            session.SourceChecksum = sourceChecksum;
+            session.Codec = codec;
+        }
+        session.PartsAcknowledged = resumeFrom;
+
+        // Same bytes and codec give the same base64 stream, so parts before resumeFrom are re-encoded and dropped
+        std::string sessionUrl = uploadsUrl + "/" + session.UploadId;
+        SaveBuffer part;
+        size_t partIndex = 0;
+        std::string failure;
+        auto sendPart = [&]() -> bool {
+            size_t index = partIndex++;
+            if (index < resumeFrom) {
+                part.clear();
+                return true;
+            }
+
+            Sha256 partHash;
+            partHash.Update(part.data(), part.size());
+            std::string checksumHeader = "X-Part-Checksum: " + partHash.HexDigest();
+            std::string partUrl = sessionUrl + "/parts/" + std::to_string(index);
+
+            for (int attempt = 0; attempt < maxRetriesPerPart; ++attempt) {
+                if (attempt > 0) {
+                    Internal::Counters().SavePartRetries.fetch_add(1, std::memory_order_relaxed);
+                    std::this_thread::sleep_for(std::chrono::milliseconds(250 << std::min(attempt, 5)));
+                }
+                long status = SendUploadRequest("PUT", partUrl, *context, "Content-Type: text/plain", part.data(), part.size(), checksumHeader, failure);
+                if (status >= 200 && status < 300) {
+                    Internal::Counters().SavePartsSent.fetch_add(1, std::memory_order_relaxed);
+                    session.PartsAcknowledged = index + 1;
+                    part.clear();
+                    return true;
+                }
+                if (status >= 400 && status < 500 && status != 408 && status != 429) break; // Not retryable
+            }
+            return false;
+        };
+
+        SavePayloadEncoder encoder([&](const char* chunk, size_t length) {
+            while (length > 0) {
+                size_t take = std::min(length, session.PartSize - part.size());
+                part.append(chunk, take);
+                chunk += take;
+                length -= take;
+                if (part.size() == session.PartSize && !sendPart()) return false;
+            }
+            return true;
+        });
+        encoder.SetSourceSize(file.GetSize());
+
+        bool ok = true;
+        for (size_t offset = 0; ok && offset < file.GetSize(); offset += kStreamChunk) {
+            ok = encoder.Write(file.GetData() + offset, std::min(kStreamChunk, file.GetSize() - offset));
+        }
+        ok = ok && encoder.Finish() && (part.empty() || sendPart());
+        if (!ok) return failure.empty() ? "Chunked upload failed" : failure;
+
+        std::string body = R"({"parts":)" + std::to_string(partIndex) +
+                           R"(,"checksum":")" + encoder.GetChecksum() +
+                           R"(","codec":")" + Internal::EscapeJSON(codec) + R"("})";
+        long status = SendUploadRequest("POST", sessionUrl + "/complete", *context, "Content-Type: application/json", body.data(), body.size(), "", response);
+        if (status >= 200 && status < 300) session = SaveUploadSession();
+        return response;
+    }
+
+    bool DecodeSavePayload(const std::string& payloadBase64, const std::string& codec, std::string& raw, std::string* checksum)
+    {
+        raw.clear();
+        SavePayloadDecoder decoder([&raw](const char* chunk, size_t length) {
+            raw.append(chunk, length);
+            return true;
+        }, codec);
+        if (!decoder.IsValid()) return false;
+        if (!decoder.Write(payloadBase64.data(), payloadBase64.size()) || !decoder.Finish()) return false;
+        if (checksum) *checksum = decoder.GetChecksum();
+        return true;
+    }
+
+    // --- Batch transfers ---
+
+    namespace
+    {
+        // Runs transfer for every item on up to maxConcurrent threads and fills in the totals
+        SaveBatchResult RunSaveBatch(const std::vector<SaveTransferItem>& items, int maxConcurrent,
+                                     const std::function<void(const SaveTransferItem&, SaveBatchResult::Item&)>& transfer)
+        {
+            SaveBatchResult result;
+            result.Items.resize(items.size());
+            auto start = std::chrono::steady_clock::now();
+
+            Internal::ParallelFor(items.size(), size_t(maxConcurrent > 0 ? maxConcurrent : 1), [&](size_t i) {
+                result.Items[i].SlotIndex = items[i].SaveData.SlotIndex;
+                transfer(items[i], result.Items[i]);
+            }, Internal::IoExecutor());
+
+            for (const SaveBatchResult::Item& item : result.Items) {
+                if (item.Success) {
+                    result.Succeeded++;
+                    result.TotalBytes += item.Bytes;
+                } else if (item.Conflict) {
+                    result.Conflicts++;
+                } else {
+                    result.Failed++;
+                }
+            }
+            result.Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            if (result.Seconds > 0) result.ThroughputMBps = double(result.TotalBytes) / (1024.0 * 1024.0) / result.Seconds;
+            return result;
+        }
+    }
+
+    SaveBatchResult StoreSavesBatch(const std::string& titleToken, const std::string& titleId, const std::string& installId,
+                                    const std::vector<SaveTransferItem>& items, int maxConcurrent)
+    {
+        return RunSaveBatch(items, maxConcurrent, [&](const SaveTransferItem& item, SaveBatchResult::Item& out) {
+            if (item.FilePath.empty()) {
+                out.Response = TitleContext::Get(titleToken, titleId)->StoreSave(installId, item.SaveData, &out.StatusCode);
+                out.Bytes = item.SaveData.PayloadBase64.size() / 4 * 3;
+            } else {
+                std::ifstream file(item.FilePath.c_str(), std::ios::binary | std::ios::ate);
+                if (file.is_open()) out.Bytes = size_t(file.tellg());
+                out.Response = StoreSaveFile(titleToken, titleId, installId, item.SaveData, item.FilePath, &out.StatusCode);
+            }
+            out.Success = out.StatusCode >= 200 && out.StatusCode < 300;
+            out.Conflict = out.StatusCode == 409;
+        });
+    }
+
+    SaveBatchResult DownloadSavesBatch(const std::string& titleToken, const std::string& titleId, const std::string& installId,
+                                       const std::vector<SaveTransferItem>& items, int maxConcurrent)
+    {
+        return RunSaveBatch(items, maxConcurrent, [&](const SaveTransferItem& item, SaveBatchResult::Item& out) {
+            SaveDownloadResult download = DownloadSaveToFile(titleToken, titleId, installId, item.SaveId, item.FilePath, item.CodecHint);
+            out.Success = download.Success;
+            out.Response = download.Success ? download.Response : download.Error;
+            out.Bytes = download.Bytes;
+        });
+    }
+
+    // --- Save sync worker ---
+
+    struct SaveSyncWorker::State
+    {
+        std::string TitleToken;
+        std::string TitleId;
+        std::string InstallId;
+
+        mutable std::mutex Mutex;
+        std::condition_variable Wake;
+        std::condition_variable Idle;
+
+        Internal::TaggedMap<int, GameSaveData, MemoryTag::Queues> Dirty; // Latest unsent save per slot
+        Internal::TaggedMap<int, int, MemoryTag::Queues> Versions;      // Last version the server acknowledged
+        std::set<int> Paused;                   // Slots waiting for conflict resolution
+        std::set<int> FlushPending;             // Slots Flush() is waiting on
+        Internal::TaggedMap<int, std::chrono::steady_clock::time_point, MemoryTag::Queues> RetryAt;
+        Internal::TaggedMap<int, int, MemoryTag::Queues> Failures;
+        std::function<void(const SaveConflict&)> OnConflict;
+        std::function<void(const SaveRejection&)> OnRejection;
+        MetadataPolicy InvalidMetadata = MetadataPolicy::WrapAsString;
+        std::string QuarantinePath;
+
+        bool Uploading = false;
+        bool Stopping = false;
+        CancellationToken Cancel = CancellationToken::Create(); // Aborts the upload in flight on destruction
+        std::thread Worker;
+
+        void Run();
+        void HandleResponse(int slotIndex, long status, const std::string& response);
+    };
+
+    void SaveSyncWorker::State::Run()
+    {
+        RequestOptions options;
+        options.Cancel = Cancel;
+        RequestScope scope(options);
+        std::unique_lock<std::mutex> lock(Mutex);
+        while (!Stopping) {
+            auto now = std::chrono::steady_clock::now();
+            auto nextRetry = std::chrono::steady_clock::time_point::max();
+            int slot = -1;
+            for (const auto& pair : Dirty) {
+                if (Paused.count(pair.first)) continue;
+                auto retry = RetryAt.find(pair.first);
+                bool flushing = FlushPending.count(pair.first) != 0;
+                if (retry == RetryAt.end() || retry->second <= now || flushing) {
+                    slot = pair.first;
+                    break;
+                }
+                if (retry->second < nextRetry) nextRetry = retry->second;
+            }
+
+            if (slot < 0) {
+                FlushPending.clear();
+                Idle.notify_all();
+                Wake.wait_until(lock, nextRetry);
+                continue;
+            }
+
+            GameSaveData save = std::move(Dirty[slot]);
+            Dirty.erase(slot);
+            auto version = Versions.find(slot);
+            if (version != Versions.end()) save.BaseVersion = version->second;
+
+            Uploading = true;
+            lock.unlock();
+            // Building the body copies the whole payload: CPU work for the host's executor.
+            // The upload itself stays on this thread.
+            std::shared_ptr<const TitleContext> context = TitleContext::Get(TitleToken, TitleId);
+            Internal::JsonString body;
+            Internal::RunOnExecutor([&body, &save]() { body = Internal::SaveJSON(save); });
+            long status = 0;
+            std::string response = context->Send(context->InstallUrl(InstallId, "/saves"), body.data(), body.size(), &status);
+            lock.lock();
+            Uploading = false;
+
+            if (Internal::IsRetryableStatus(status)) {
+                // Retry with backoff unless the game already handed over something newer
+                if (!Dirty.count(slot)) Dirty[slot] = std::move(save);
+                int failures = ++Failures[slot];
+                int delaySeconds = failures < 6 ? (1 << failures) : 60;
+                RetryAt[slot] = std::chrono::steady_clock::now() + std::chrono::seconds(delaySeconds);
+            } else {
+                RetryAt.erase(slot);
+                Failures.erase(slot);
+                HandleResponse(slot, status, response);
+            }
+            FlushPending.erase(slot);
+            if (FlushPending.empty()) Idle.notify_all();
+        }
+    }
+
+    // Called with Mutex held
+    void SaveSyncWorker::State::HandleResponse(int slotIndex, long status, const std::string& response)
+    {
+        SaveConflict conflict;
+        if (Internal::ExtractJSONString(response, "conflict_id", conflict.ConflictId)) {
+            Internal::Counters().SaveConflicts.fetch_add(1, std::memory_order_relaxed);
+            Paused.insert(slotIndex);
+            if (!Internal::ExtractJSONString(response, "save_id", conflict.SaveId)) {
+                Internal::ExtractJSONString(response, "id", conflict.SaveId);
+            }
+            conflict.SlotIndex = slotIndex;
+            conflict.Response = response;
+
+            auto callback = OnConflict;
+            if (callback) {
+                Mutex.unlock();
+                callback(conflict);
+                Mutex.lock();
+            }
+            return;
+        }
+
+        if (status < 200 || status >= 300) {
+            Internal::Counters().SavesRejected.fetch_add(1, std::memory_order_relaxed);
+            SaveRejection rejection;
+            rejection.SlotIndex = slotIndex;
+            rejection.StatusCode = status;
+            rejection.Response = response;
+
+            auto callback = OnRejection;
+            if (callback) {
+                Mutex.unlock();
+                callback(rejection);
+                Mutex.lock();
+            }
+            return;
+        }
+
+        // Only data.version is the stored save's version; metadata may carry its own
+        std::string data, version;
+        if (Internal::ExtractJSONField(response, "data", data) && Internal::ExtractJSONField(data, "version", version)) {
+            char* end = nullptr;
+            double number = std::strtod(version.c_str(), &end);
+            if (end == version.c_str()) return;
+            Versions[slotIndex] = int(number);
+            Internal::Counters().SavesUploaded.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    SaveSyncWorker::SaveSyncWorker(const std::string& titleToken, const std::string& titleId, const std::string& installId)
+        : Impl(new State())
+    {
+        Impl->TitleToken = titleToken;
+        Impl->TitleId = titleId;
+        Impl->InstallId = installId;
+        Impl->Worker = std::thread(&State::Run, Impl.get());
+    }
+
+    SaveSyncWorker::~SaveSyncWorker()
+    {
+        {
+            std::lock_guard<std::mutex> lock(Impl->Mutex);
+            Impl->Stopping = true;
+        }
+        Impl->Cancel.Cancel();
+        Impl->Wake.notify_all();
+        Impl->Idle.notify_all();
+        if (Impl->Worker.joinable()) Impl->Worker.join();
+    }
+
+    QueueResult SaveSyncWorker::MarkDirty(GameSaveData saveData)
+    {
+        MetadataPolicy policy;
+        std::string quarantinePath;
+        {
+            std::lock_guard<std::mutex> lock(Impl->Mutex);
+            policy = Impl->InvalidMetadata;
+            quarantinePath = Impl->QuarantinePath;
+        }
+
+        std::string rawMetadata = saveData.MetadataJSON;
+        size_t errorOffset = 0;
+        QueueResult result = Internal::CheckMetadata(saveData.MetadataJSON, policy, &errorOffset);
+        if (result == QueueResult::Rejected) return result;
+        if (result == QueueResult::Quarantined) {
+            // The payload can be large and the game still has it, so only the save's description is kept
+            Internal::JsonStream json;
+            json << "{"
+                 << R"("slot_index":)" << saveData.SlotIndex << ","
+                 << R"("checksum":")" << saveData.Checksum << R"(",)"
+                 << R"("base_version":)" << saveData.BaseVersion << ","
+                 << R"("save_type":")" << Internal::EscapeJSON(saveData.SaveType) << R"(",)"
+                 << R"("client_timestamp":")" << Internal::EscapeJSON(saveData.ClientTimestamp) << R"(")"
+                 << "}";
+            Internal::AppendQuarantine(quarantinePath, "save", errorOffset, rawMetadata, json.str());
+            return result;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(Impl->Mutex);
+            auto existing = Impl->Dirty.find(saveData.SlotIndex);
+            if (existing != Impl->Dirty.end()) {
+                Internal::Counters().SavesSuperseded.fetch_add(1, std::memory_order_relaxed);
+                existing->second = std::move(saveData);
+            } else {
+                int slot = saveData.SlotIndex;
+                Impl->Dirty[slot] = std::move(saveData);
+            }
+        }
+        Impl->Wake.notify_all();
+        return result;
+    }
+
+    void SaveSyncWorker::SetBaseVersion(int slotIndex, int version)
+    {
+        {
+            std::lock_guard<std::mutex> lock(Impl->Mutex);
+            Impl->Versions[slotIndex] = version;
+            Impl->Paused.erase(slotIndex);
+        }
+        Impl->Wake.notify_all();
+    }
+
+    int SaveSyncWorker::GetBaseVersion(int slotIndex) const
+    {
+        std::lock_guard<std::mutex> lock(Impl->Mutex);
+        auto version = Impl->Versions.find(slotIndex);
+        return version != Impl->Versions.end() ? version->second : 0;
+    }
+
+    void SaveSyncWorker::SetConflictCallback(std::function<void(const SaveConflict&)> callback)
+    {
+        std::lock_guard<std::mutex> lock(Impl->Mutex);
+        Impl->OnConflict = callback;
+    }
+
+    void SaveSyncWorker::SetRejectionCallback(std::function<void(const SaveRejection&)> callback)
+    {
+        std::lock_guard<std::mutex> lock(Impl->Mutex);
+        Impl->OnRejection = callback;
+    }
+
+    void SaveSyncWorker::SetMetadataPolicy(MetadataPolicy policy, const std::string& quarantinePath)
+    {
+        std::lock_guard<std::mutex> lock(Impl->Mutex);
+        Impl->InvalidMetadata = policy;
+        Impl->QuarantinePath = quarantinePath;
+    }
+
+    void SaveSyncWorker::Flush()
+    {
+        std::unique_lock<std::mutex> lock(Impl->Mutex);
+        for (const auto& pair : Impl->Dirty) {
+            if (!Impl->Paused.count(pair.first)) Impl->FlushPending.insert(pair.first);
+        }
+        Impl->Wake.notify_all();
+        State* state = Impl.get();
+        state->Idle.wait(lock, [state]() {
+            return state->Stopping || (state->FlushPending.empty() && !state->Uploading);
+        });
+    }
+
+} // namespace GlitchSDK
@@ -0,0 +1,1302 @@
+#include "GlitchSDK.h"
+#include <openssl/evp.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+
+namespace GlitchSDK
+{
+    // --- Request bodies ---
+
+    size_t BodySegments::Read(char* buffer, size_t size)
+    {
+        size_t written = 0;
+        while (written < size && Index < Segments.size()) {
+            const Segment& segment = Segments[Index];
+            size_t length = std::min(size - written, segment.Size - Offset);
+            memcpy(buffer + written, segment.Data + Offset, length);
+            written += length;
+            Offset += length;
+            if (Offset == segment.Size) {
+                Index++;
+                Offset = 0;
+            }
+        }
+        return written;
+    }
+
+    // --- Deadlines and cancellation ---
+
+    namespace
+    {
+        // TimeoutPolicy fields as atomics so every request can read them without a lock
+        struct EndpointLimits
+        {
+            std::atomic<int64_t> ConnectMs;
+            std::atomic<int64_t> TotalMs;
+            std::atomic<long> LowSpeedBytes;
+            std::atomic<int64_t> LowSpeedSeconds;
+
+            void Store(const TimeoutPolicy& policy)
+            {
+                ConnectMs.store(policy.Connect.count(), std::memory_order_relaxed);
+                TotalMs.store(policy.Total.count(), std::memory_order_relaxed);
+                LowSpeedBytes.store(policy.LowSpeedBytes, std::memory_order_relaxed);
+                LowSpeedSeconds.store(policy.LowSpeedTime.count(), std::memory_order_relaxed);
+            }
+        };
+
+        TimeoutPolicy DefaultTimeoutPolicy(Endpoint endpoint)
+        {
+            TimeoutPolicy policy;
+            policy.Connect = std::chrono::seconds(10);
+            switch (endpoint) {
+            case Endpoint::Validate: policy.Total = std::chrono::seconds(10); break;
+            case Endpoint::Wishlist: policy.Total = std::chrono::seconds(15); break;
+            case Endpoint::Saves:
+                policy.LowSpeedBytes = 1024;
+                policy.LowSpeedTime = std::chrono::seconds(30);
+                break;
+            default: policy.Total = std::chrono::seconds(30); break;
+            }
+            return policy;
+        }
+
+        struct TimeoutTable
+        {
+            EndpointLimits Entries[size_t(Endpoint::Count)];
+
+            TimeoutTable()
+            {
+                for (size_t i = 0; i < size_t(Endpoint::Count); ++i) Entries[i].Store(DefaultTimeoutPolicy(Endpoint(i)));
+            }
+        };
+
+        TimeoutTable& Timeouts()
+        {
+            static TimeoutTable table;
+            return table;
+        }
+
+        thread_local const RequestScope* t_requestScope = nullptr;
+
+        // splitmix64 seeded once per thread; trace IDs need to be unique, not unpredictable
+        uint64_t NextTraceRandom()
+        {
+            thread_local uint64_t state = 0;
+            if (state == 0) {
+                std::random_device device;
+                state = (uint64_t(device()) << 32) ^ device() ^
+                        uint64_t(std::chrono::steady_clock::now().time_since_epoch().count()) ^ uint64_t(uintptr_t(&state));
+                if (state == 0) state = 1;
+            }
+            uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            return z ^ (z >> 31);
+        }
+
+        void AppendTraceHex(char* out, uint64_t value)
+        {
+            static const char hex[] = "0123456789abcdef";
+            for (int i = 15; i >= 0; --i, value >>= 4) out[i] = hex[value & 15];
+        }
+
+        bool IsTraceId(const std::string& id)
+        {
+            if (id.size() != 32 || id.find_first_not_of('0') == std::string::npos) return false;
+            return id.find_first_not_of("0123456789abcdef") == std::string::npos;
+        }
+
+        // "00-<trace id>-<span id>-01"; every request is a new span
+        void FormatTraceParent(char (&out)[56], const std::string& traceId)
+        {
+            memcpy(out, "00-", 3);
+            if (IsTraceId(traceId)) {
+                memcpy(out + 3, traceId.data(), 32);
+            } else {
+                AppendTraceHex(out + 3, NextTraceRandom());
+                AppendTraceHex(out + 19, NextTraceRandom());
+            }
+            out[35] = '-';
+            AppendTraceHex(out + 36, NextTraceRandom() | 1); // An all-zero span ID is invalid
+            memcpy(out + 52, "-01", 4);
+        }
+
+        typedef std::function<void(const RequestRecord&)> RequestObserver;
+
+        std::shared_ptr<RequestObserver>& ObserverSlot()
+        {
+            static std::shared_ptr<RequestObserver> observer;
+            return observer;
+        }
+
+        std::atomic<bool> g_hasObserver(false); // Skips the shared_ptr load when nobody listens
+
+        void ObservePhases(Endpoint endpoint, const RequestTiming& timing)
+        {
+            Internal::HistogramCounters* phases = Internal::Counters().RequestPhases[size_t(endpoint)];
+            auto observe = [phases](RequestPhase phase, double from, double to) {
+                if (to > 0.0) phases[size_t(phase)].Observe(std::max(to - from, 0.0));
+            };
+            observe(RequestPhase::NameLookup, 0.0, timing.NameLookup);
+            observe(RequestPhase::Connect, timing.NameLookup, timing.Connect);
+            observe(RequestPhase::Tls, timing.Connect, timing.AppConnect);
+            observe(RequestPhase::Server, timing.PreTransfer, timing.StartTransfer);
+            if (timing.StartTransfer > 0.0) observe(RequestPhase::Download, timing.StartTransfer, timing.Total);
+        }
+    }
+
+    void SetRequestObserver(std::function<void(const RequestRecord&)> observer)
+    {
+        std::shared_ptr<RequestObserver> slot;
+        if (observer) slot = std::make_shared<RequestObserver>(std::move(observer));
+        std::atomic_store(&ObserverSlot(), slot);
+        g_hasObserver.store(slot != nullptr, std::memory_order_release);
+    }
+
+    void SetTimeoutPolicy(Endpoint endpoint, const TimeoutPolicy& policy)
+    {
+        if (endpoint >= Endpoint::Count) return;
+        Timeouts().Entries[size_t(endpoint)].Store(policy);
+    }
+
+    TimeoutPolicy GetTimeoutPolicy(Endpoint endpoint)
+    {
+        TimeoutPolicy policy;
+        if (endpoint >= Endpoint::Count) return policy;
+        const EndpointLimits& limits = Timeouts().Entries[size_t(endpoint)];
+        policy.Connect = std::chrono::milliseconds(limits.ConnectMs.load(std::memory_order_relaxed));
+        policy.Total = std::chrono::milliseconds(limits.TotalMs.load(std::memory_order_relaxed));
+        policy.LowSpeedBytes = limits.LowSpeedBytes.load(std::memory_order_relaxed);
+        policy.LowSpeedTime = std::chrono::seconds(limits.LowSpeedSeconds.load(std::memory_order_relaxed));
+        return policy;
+    }
+
+    RequestScope::RequestScope(const RequestOptions& options) : Options(options), Outer(t_requestScope)
+    {
+        if (Outer) {
+            Options.Deadline = std::min(Options.Deadline, Outer->Options.Deadline);
+            if (!Options.Cancel.CanBeCancelled()) Options.Cancel = Outer->Options.Cancel;
+        }
+        t_requestScope = this;
+    }
+
+    RequestScope::~RequestScope()
+    {
+        t_requestScope = Outer;
+    }
+
+    const RequestScope* RequestScope::Current()
+    {
+        return t_requestScope;
+    }
+
+    void Internal::SetRequestFailure(HttpResponse& response, RequestFailure failure)
+    {
+        CURLcode code = failure == RequestFailure::Cancelled ? CURLE_ABORTED_BY_CALLBACK : CURLE_OPERATION_TIMEDOUT;
+        response.StatusCode = 0;
+        response.Error = "CURL error: " + std::string(curl_easy_strerror(code));
+        response.Failure = failure;
+    }
+
+    HttpResponse Internal::SendRequest(HttpRequest& request, Endpoint endpoint)
+    {
+        TimeoutPolicy policy = GetTimeoutPolicy(endpoint);
+        request.ConnectTimeout = policy.Connect;
+        request.Timeout = policy.Total;
+        request.LowSpeedBytes = policy.LowSpeedBytes;
+        request.LowSpeedTime = policy.LowSpeedTime;
+
+        HttpResponse response;
+        const RequestScope* scope = RequestScope::Current();
+        FormatTraceParent(request.TraceParent, scope ? scope->GetOptions().TraceId : std::string());
+        if (scope) {
+            const RequestOptions& options = scope->GetOptions();
+            request.Cancel = options.Cancel;
+            if (options.Deadline != std::chrono::steady_clock::time_point::max()) {
+                auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(options.Deadline - std::chrono::steady_clock::now());
+                if (remaining.count() <= 0) SetRequestFailure(response, RequestFailure::Timeout);
+                else if (request.Timeout.count() == 0 || remaining < request.Timeout) request.Timeout = remaining;
+            }
+        }
+
+        // Nothing is sent once the deadline has passed or the token is cancelled
+        if (response.Failure == RequestFailure::None) {
+            if (request.Cancel.IsCancelled()) {
+                SetRequestFailure(response, RequestFailure::Cancelled);
+            } else {
+                auto start = std::chrono::steady_clock::now();
+                response = GetTransport()->Send(request);
+                double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                Counters().RequestLatency[size_t(endpoint)].Observe(seconds);
+                ObservePhases(endpoint, response.Timing);
+                if (response.Timing.Total <= 0.0) response.Timing.Total = seconds;
+            }
+        }
+
+        if (g_hasObserver.load(std::memory_order_acquire)) {
+            if (std::shared_ptr<RequestObserver> observer = std::atomic_load(&ObserverSlot())) {
+                RequestRecord record;
+                record.Group = endpoint;
+                record.Method = request.Method;
+                record.Url = request.Url.c_str();
+                record.TraceParent = request.TraceParent;
+                record.StatusCode = response.StatusCode;
+                record.Failure = response.Failure;
+                record.Timing = response.Timing;
+                (*observer)(record);
+            }
+        }
+
+        MetricCounters& counters = Counters();
+        switch (response.Failure) {
+        case RequestFailure::Timeout: counters.RequestTimeouts.fetch_add(1, std::memory_order_relaxed); break;
+        case RequestFailure::ConnectTimeout: counters.ConnectTimeouts.fetch_add(1, std::memory_order_relaxed); break;
+        case RequestFailure::Cancelled: counters.RequestsCancelled.fetch_add(1, std::memory_order_relaxed); break;
+        default: break;
+        }
+        return response;
+    }
+
+    // --- Curl transport ---
+
+    namespace
+    {
+        // Per-thread easy handle. curl_easy_reset keeps the connection cache, so
+        // consecutive requests from a thread reuse the TCP/TLS connection.
+        struct ThreadCurlHandle
+        {
+            CURL* Curl = nullptr;
+            bool InUse = false;
+            ~ThreadCurlHandle() { if (Curl) curl_easy_cleanup(Curl); }
+        };
+
+        thread_local ThreadCurlHandle t_curlHandle;
+
+        struct CurlTransfer
+        {
+            const HttpRequest* Request;
+            HttpResponse* Response;
+            CURL* Curl;
+            bool StatusChecked = false;
+            bool ToSink = false;
+        };
+
+        size_t CurlWriteBody(char* ptr, size_t size, size_t nmemb, void* userdata)
+        {
+            CurlTransfer* transfer = (CurlTransfer*)userdata;
+            size_t length = size * nmemb;
+            if (!transfer->StatusChecked) {
+                transfer->StatusChecked = true;
+                long status = 0;
+                curl_easy_getinfo(transfer->Curl, CURLINFO_RESPONSE_CODE, &status);
+                transfer->ToSink = transfer->Request->ResponseSink && status >= 200 && status < 300;
+            }
+            if (transfer->ToSink) return transfer->Request->ResponseSink(ptr, length) ? length : 0;
+            transfer->Response->Body.append(ptr, length);
+            return length;
+        }
+
+        size_t CurlReadBody(char* buffer, size_t size, size_t nitems, void* userdata)
+        {
+            CurlTransfer* transfer = (CurlTransfer*)userdata;
+            return transfer->Request->BodyReader(buffer, size * nitems);
+        }
+
+        // curl only ever seeks back to the start, to resend the body
+        int CurlSeekBody(void* userdata, curl_off_t offset, int origin)
+        {
+            CurlTransfer* transfer = (CurlTransfer*)userdata;
+            if (offset != 0 || origin != SEEK_SET) return CURL_SEEKFUNC_CANTSEEK;
+            return transfer->Request->BodyRewind() ? CURL_SEEKFUNC_OK : CURL_SEEKFUNC_FAIL;
+        }
+
+        // Called by curl several times a second while a transfer runs, even when it is idle
+        int CurlProgress(void* userdata, curl_off_t, curl_off_t, curl_off_t, curl_off_t)
+        {
+            CurlTransfer* transfer = (CurlTransfer*)userdata;
+            return transfer->Request->Cancel.IsCancelled() ? 1 : 0;
+        }
+
+        RequestFailure CurlFailure(CURL* curl, CURLcode result, const HttpRequest& request)
+        {
+            if (result == CURLE_ABORTED_BY_CALLBACK && request.Cancel.IsCancelled()) return RequestFailure::Cancelled;
+            if (result != CURLE_OPERATION_TIMEDOUT) return RequestFailure::Other;
+
+            // Timed out before the TCP (and for https, TLS) handshake completed
+            double connected = 0.0;
+            double secured = 0.0;
+            curl_easy_getinfo(curl, CURLINFO_CONNECT_TIME, &connected);
+            curl_easy_getinfo(curl, CURLINFO_APPCONNECT_TIME, &secured);
+            bool https = request.Url.compare(0, 8, "https://") == 0;
+            return connected <= 0.0 || (https && secured <= 0.0) ? RequestFailure::ConnectTimeout : RequestFailure::Timeout;
+        }
+    }
+
+    HttpResponse CurlTransport::Send(const HttpRequest& request)
+    {
+        HttpResponse response;
+
+        // A sink or reader that itself sends a request gets a private handle
+        bool nested = t_curlHandle.InUse;
+        CURL* curl = nested ? curl_easy_init() : t_curlHandle.Curl;
+        if (!nested && !curl) curl = t_curlHandle.Curl = curl_easy_init();
+        else if (!nested) curl_easy_reset(curl);
+        if (!curl) {
+            response.Error = "Failed to init curl";
+            response.Failure = RequestFailure::Other;
+            return response;
+        }
+        if (!nested) t_curlHandle.InUse = true;
+
+        CurlTransfer transfer;
+        transfer.Request = &request;
+        transfer.Response = &response;
+        transfer.Curl = curl;
+
+        // The trace header is a stack node in front of the shared list, so no copy is made
+        char traceHeader[72];
+        curl_slist traceNode;
+        curl_slist* headers = (curl_slist*)request.Headers;
+        if (request.TraceParent[0]) {
+            snprintf(traceHeader, sizeof(traceHeader), "traceparent: %s", request.TraceParent);
+            traceNode.data = traceHeader;
+            traceNode.next = headers;
+            headers = &traceNode;
+        }
+
+        // Timeouts must not use SIGALRM (the synchronous resolver's default) in a threaded
+        // process; curl_easy_reset clears this, so it is set for every request
+        curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+        curl_easy_setopt(curl, CURLOPT_URL, request.Url.c_str());
+        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
+        if (strcmp(request.Method, "GET") != 0) {
+            curl_easy_setopt(curl, CURLOPT_POST, 1L);
+            if (strcmp(request.Method, "POST") != 0) curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST, request.Method);
+            if (request.Body) {
+                curl_easy_setopt(curl, CURLOPT_POSTFIELDS, request.Body);
+                curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE_LARGE, (curl_off_t)request.BodySize);
+            } else if (request.BodyReader) {
+                curl_easy_setopt(curl, CURLOPT_READFUNCTION, CurlReadBody);
+                curl_easy_setopt(curl, CURLOPT_READDATA, &transfer);
+                if (request.BodyRewind) {
+                    curl_easy_setopt(curl, CURLOPT_SEEKFUNCTION, CurlSeekBody);
+                    curl_easy_setopt(curl, CURLOPT_SEEKDATA, &transfer);
+                }
+                if (request.BodySize >= 0) {
+                    curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE_LARGE, (curl_off_t)request.BodySize);
+                } // else curl falls back to chunked transfer encoding
+            } else {
+                curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, 0L);
+            }
+        }
+        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, CurlWriteBody);
+        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &transfer);
+
+        if (request.ConnectTimeout.count() > 0) curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT_MS, (long)request.ConnectTimeout.count());
+        if (request.Timeout.count() > 0) curl_easy_setopt(curl, CURLOPT_TIMEOUT_MS, (long)request.Timeout.count());
+        if (request.LowSpeedBytes > 0 && request.LowSpeedTime.count() > 0) {
+            curl_easy_setopt(curl, CURLOPT_LOW_SPEED_LIMIT, request.LowSpeedBytes);
+            curl_easy_setopt(curl, CURLOPT_LOW_SPEED_TIME, (long)request.LowSpeedTime.count());
+        }
+        if (request.Cancel.CanBeCancelled()) {
+            curl_easy_setopt(curl, CURLOPT_XFERINFOFUNCTION, CurlProgress);
+            curl_easy_setopt(curl, CURLOPT_XFERINFODATA, &transfer);
+            curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 0L);
+        }
+
+        CURLcode res = curl_easy_perform(curl);
+        curl_easy_getinfo(curl, CURLINFO_NAMELOOKUP_TIME, &response.Timing.NameLookup);
+        curl_easy_getinfo(curl, CURLINFO_CONNECT_TIME, &response.Timing.Connect);
+        curl_easy_getinfo(curl, CURLINFO_APPCONNECT_TIME, &response.Timing.AppConnect);
+        curl_easy_getinfo(curl, CURLINFO_PRETRANSFER_TIME, &response.Timing.PreTransfer);
+        curl_easy_getinfo(curl, CURLINFO_STARTTRANSFER_TIME, &response.Timing.StartTransfer);
+        curl_easy_getinfo(curl, CURLINFO_TOTAL_TIME, &response.Timing.Total);
+        if (res != CURLE_OK) {
+            response.Error = "CURL error: " + std::string(curl_easy_strerror(res));
+            response.Failure = CurlFailure(curl, res, request);
+        } else {
+            curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &response.StatusCode);
+#if LIBCURL_VERSION_NUM >= 0x074200
+            curl_off_t retryAfter = 0;
+            if (curl_easy_getinfo(curl, CURLINFO_RETRY_AFTER, &retryAfter) == CURLE_OK && retryAfter > 0) {
+                response.RetryAfter = std::chrono::seconds(retryAfter);
+            }
+#endif
+        }
+
+        if (nested) curl_easy_cleanup(curl);
+        else t_curlHandle.InUse = false;
+        return response;
+    }
+
+    // --- Loopback transport ---
+
+    namespace
+    {
+        struct LoopbackSave
+        {
+            std::string Id;
+            int SlotIndex = 0;
+            int Version = 0;
+            std::string Payload;
+            std::string Checksum;
+            std::string Codec;
+        };
+
+        struct LoopbackUpload
+        {
+            std::string InstallId;
+            int SlotIndex = 0;
+            int BaseVersion = 0;
+            size_t PartSize = 0;
+            std::map<size_t, std::string> Parts;
+        };
+
+        std::string Sha256Hex(const std::string& data)
+        {
+            unsigned char digest[EVP_MAX_MD_SIZE];
+            unsigned int length = 0;
+            EVP_Digest(data.data(), data.size(), digest, &length, EVP_sha256(), NULL);
+            static const char hex[] = "0123456789abcdef";
+            std::string out;
+            for (unsigned int i = 0; i < length; ++i) {
+                out += hex[digest[i] >> 4];
+                out += hex[digest[i] & 15];
+            }
+            return out;
+        }
+
+        std::string FindHeader(const curl_slist* headers, const char* name)
+        {
+            size_t nameLength = strlen(name);
+            for (const curl_slist* header = headers; header; header = header->next) {
+                if (strncmp(header->data, name, nameLength) == 0 && header->data[nameLength] == ':') {
+                    const char* value = header->data + nameLength + 1;
+                    while (*value == ' ') ++value;
+                    return value;
+                }
+            }
+            return std::string();
+        }
+
+        HttpResponse Reply(long status, const std::string& body)
+        {
+            HttpResponse response;
+            response.StatusCode = status;
+            response.Body = body;
+            return response;
+        }
+    }
+
+    struct LoopbackTransport::State
+    {
+        std::mutex Mutex;
+        uint64_t Requests = 0;
+        std::map<std::string, uint64_t> NextIds;                        // per id prefix
+        std::map<std::string, std::map<int, LoopbackSave> > Saves;     // installId -> slot -> save
+        std::map<std::string, LoopbackSave> Conflicts;                  // conflictId -> rejected client save
+        std::map<std::string, LoopbackUpload> Uploads;
+        std::map<std::string, bool> Wishlist;                           // token + title -> wishlisted
+
+        std::string NewId(const char* prefix)
+        {
+            std::stringstream ss;
+            ss << prefix << "-" << ++NextIds[prefix];
+            return ss.str();
+        }
+
+        HttpResponse Route(const HttpRequest& request, const std::string& body);
+        HttpResponse StoreSave(const std::string& installId, LoopbackSave save, int baseVersion);
+        HttpResponse SaveRoute(const HttpRequest& request, const std::string& body, const std::vector<std::string>& path);
+    };
+
+    HttpResponse LoopbackTransport::State::StoreSave(const std::string& installId, LoopbackSave save, int baseVersion)
+    {
+        std::string raw, checksum;
+        if (!DecodeSavePayload(save.Payload, save.Codec, raw, &checksum) || checksum != save.Checksum) {
+            return Reply(422, R"({"error":"checksum_mismatch"})");
+        }
+
+        std::map<int, LoopbackSave>& slots = Saves[installId];
+        auto existing = slots.find(save.SlotIndex);
+        int currentVersion = existing != slots.end() ? existing->second.Version : 0;
+        if (existing != slots.end() && baseVersion != currentVersion) {
+            std::string conflictId = NewId("conflict");
+            save.Id = existing->second.Id;
+            save.Version = currentVersion;
+            Conflicts[conflictId] = save;
+            return Reply(409, R"({"error":"conflict","conflict_id":")" + conflictId +
+                              R"(","save_id":")" + save.Id + R"(","server_version":)" + std::to_string(currentVersion) + "}");
+        }
+
+        save.Id = existing != slots.end() ? existing->second.Id : NewId("save");
+        save.Version = currentVersion + 1;
+        slots[save.SlotIndex] = save;
+        return Reply(201, R"({"data":{"id":")" + save.Id + R"(","slot_index":)" + std::to_string(save.SlotIndex) +
+                          R"(,"version":)" + std::to_string(save.Version) + "}}");
+    }
+
+    // path: titles/{t}/installs/{i}/saves/...
+    HttpResponse LoopbackTransport::State::SaveRoute(const HttpRequest& request, const std::string& body,
+                                                     const std::vector<std::string>& path)
+    {
+        const std::string& installId = path[3];
+        bool isGet = strcmp(request.Method, "GET") == 0;
+        double number = 0;
+
+        if (path.size() == 5) {
+            if (isGet) {
+                std::string list = R"({"data":[)";
+                bool first = true;
+                for (const auto& pair : Saves[installId]) {
+                    const LoopbackSave& save = pair.second;
+                    if (!first) list += ",";
+                    list += R"({"id":")" + save.Id + R"(","slot_index":)" + std::to_string(save.SlotIndex) +
+                            R"(,"version":)" + std::to_string(save.Version) + R"(,"checksum":")" + save.Checksum +
+                            R"(","codec":")" + save.Codec + R"("})";
+                    first = false;
+                }
+                return Reply(200, list + "]}");
+            }
+            LoopbackSave save;
+            Internal::ExtractJSONString(body, "payload", save.Payload);
+            Internal::ExtractJSONString(body, "checksum", save.Checksum);
+            Internal::ExtractJSONString(body, "codec", save.Codec);
+            if (Internal::ExtractJSONNumber(body, "slot_index", number)) save.SlotIndex = int(number);
+            int baseVersion = Internal::ExtractJSONNumber(body, "base_version", number) ? int(number) : 0;
+            return StoreSave(installId, save, baseVersion);
+        }
+
+        if (path[5] == "uploads") {
+            if (path.size() == 6) {
+                LoopbackUpload upload;
+                upload.InstallId = installId;
+                if (Internal::ExtractJSONNumber(body, "slot_index", number)) upload.SlotIndex = int(number);
+                if (Internal::ExtractJSONNumber(body, "base_version", number)) upload.BaseVersion = int(number);
+                upload.PartSize = Internal::ExtractJSONNumber(body, "part_size", number) ? size_t(number) : 1024 * 1024;
+                std::string uploadId = NewId("upload");
+                Uploads[uploadId] = upload;
+                return Reply(201, R"({"upload_id":")" + uploadId + R"(","part_size":)" + std::to_string(upload.PartSize) + "}");
+            }
+
+            auto found = Uploads.find(path[6]);
+            if (found == Uploads.end()) return Reply(404, R"({"error":"unknown_upload"})");
+            LoopbackUpload& upload = found->second;
+
+            if (path.size() == 7 && isGet) {
+                size_t next = 0;
+                while (upload.Parts.count(next)) ++next;
+                return Reply(200, R"({"next_part":)" + std::to_string(next) + R"(,"part_size":)" + std::to_string(upload.PartSize) + "}");
+            }
+            if (path.size() == 9 && path[7] == "parts") {
+                if (Sha256Hex(body) != FindHeader(request.Headers, "X-Part-Checksum")) {
+                    return Reply(422, R"({"error":"part_checksum_mismatch"})");
+                }
+                upload.Parts[size_t(std::stoul(path[8]))] = body;
+                return Reply(200, "{}");
+            }
+            if (path.size() == 8 && path[7] == "complete") {
+                size_t parts = Internal::ExtractJSONNumber(body, "parts", number) ? size_t(number) : 0;
+                LoopbackSave save;
+                for (size_t i = 0; i < parts; ++i) {
+                    auto part = upload.Parts.find(i);
+                    if (part == upload.Parts.end()) return Reply(409, R"({"error":"missing_part"})");
+                    save.Payload += part->second;
+                }
+                save.SlotIndex = upload.SlotIndex;
+                Internal::ExtractJSONString(body, "checksum", save.Checksum);
+                Internal::ExtractJSONString(body, "codec", save.Codec);
+                int baseVersion = upload.BaseVersion;
+                Uploads.erase(found);
+                return StoreSave(installId, save, baseVersion);
+            }
+            return Reply(404, R"({"error":"not_found"})");
+        }
+
+        // saves/{saveId}[/resolve]
+        for (auto& pair : Saves[installId]) {
+            LoopbackSave& save = pair.second;
+            if (save.Id != path[5]) continue;
+            if (path.size() == 6 && isGet) {
+                return Reply(200, R"({"data":{"id":")" + save.Id + R"(","slot_index":)" + std::to_string(save.SlotIndex) +
+                                  R"(,"version":)" + std::to_string(save.Version) + R"(,"checksum":")" + save.Checksum +
+                                  R"(","codec":")" + save.Codec + R"(","payload":")" + save.Payload + R"("}})");
+            }
+            if (path.size() == 7 && path[6] == "resolve") {
+                std::string conflictId, choice;
+                Internal::ExtractJSONString(body, "conflict_id", conflictId);
+                Internal::ExtractJSONString(body, "choice", choice);
+                auto conflict = Conflicts.find(conflictId);
+                if (conflict == Conflicts.end()) return Reply(404, R"({"error":"unknown_conflict"})");
+                if (choice == "use_client") {
+                    conflict->second.Version = save.Version + 1;
+                    save = conflict->second;
+                }
+                Conflicts.erase(conflict);
+                return Reply(200, R"({"data":{"id":")" + save.Id + R"(","version":)" + std::to_string(save.Version) + "}}");
+            }
+        }
+        return Reply(404, R"({"error":"not_found"})");
+    }
+
+    HttpResponse LoopbackTransport::State::Route(const HttpRequest& request, const std::string& body)
+    {
+        std::string authorization = FindHeader(request.Headers, "Authorization");
+        if (authorization.compare(0, 7, "Bearer ") != 0) return Reply(401, R"({"error":"unauthenticated"})");
+
+        size_t baseLength = strlen(Internal::ApiBaseUrl);
+        if (request.Url.compare(0, baseLength, Internal::ApiBaseUrl) != 0) return Reply(404, R"({"error":"not_found"})");
+
+        std::vector<std::string> path;
+        std::stringstream segments(request.Url.substr(baseLength + 1));
+        std::string segment;
+        while (std::getline(segments, segment, '/')) path.push_back(segment);
+        if (path.size() < 3 || path[0] != "titles") return Reply(404, R"({"error":"not_found"})");
+
+        const std::string& resource = path[2];
+        if (resource == "installs") {
+            if (path.size() == 3) return Reply(201, R"({"data":{"id":")" + NewId("install") + R"("}})");
+            if (path.size() == 5 && path[4] == "validate") {
+                return Reply(200, R"({"valid":true,"install_id":")" + path[3] + R"("})");
+            }
+            if (path.size() >= 5 && path[4] == "saves") return SaveRoute(request, body, path);
+        } else if (resource == "purchases" && path.size() == 3) {
+            return Reply(201, R"({"data":{"id":")" + NewId("purchase") + R"("}})");
+        } else if (resource == "events") {
+            if (path.size() == 3) return Reply(201, R"({"data":{"id":")" + NewId("event") + R"("}})");
+            if (path.size() == 4 && path[3] == "bulk") {
+                std::vector<std::string> events;
+                if (!Internal::ExtractJSONArray(body, "events", events)) return Reply(400, R"({"error":"invalid_body"})");
+
+                // One result per event, in order, like the real endpoint
+                size_t accepted = 0;
+                std::string results;
+                for (size_t i = 0; i < events.size(); ++i) {
+                    std::string stepKey, actionKey;
+                    const char* error = nullptr;
+                    if (!IsValidJSON(events[i])) error = "invalid_json";
+                    else if (!Internal::ExtractJSONString(events[i], "step_key", stepKey) || stepKey.empty()) error = "missing_step_key";
+                    else if (!Internal::ExtractJSONString(events[i], "action_key", actionKey) || actionKey.empty()) error = "missing_action_key";
+
+                    if (i > 0) results += ",";
+                    if (error) {
+                        results += R"({"status":422,"error":")" + std::string(error) + R"("})";
+                    } else {
+                        results += R"({"status":201})";
+                        accepted++;
+                    }
+                }
+                return Reply(accepted == events.size() ? 201 : 207,
+                             R"({"accepted":)" + std::to_string(accepted) + R"(,"rejected":)" + std::to_string(events.size() - accepted) +
+                             R"(,"results":[)" + results + "]}");
+            }
+        } else if (resource == "wishlist") {
+            if (path.size() == 3) {
+                bool& wishlisted = Wishlist[authorization + '\n' + path[1]];
+                wishlisted = !wishlisted;
+                return Reply(200, std::string(R"({"wishlisted":)") + (wishlisted ? "true" : "false") + "}");
+            }
+            if (path.size() == 4 && path[3] == "score") return Reply(200, "{}");
+        }
+        return Reply(404, R"({"error":"not_found"})");
+    }
+
+    LoopbackTransport::LoopbackTransport() : Impl(new State()) {}
+
+    LoopbackTransport::~LoopbackTransport() {}
+
+    HttpResponse LoopbackTransport::Send(const HttpRequest& request)
+    {
+        if (request.Cancel.IsCancelled()) {
+            HttpResponse cancelled;
+            Internal::SetRequestFailure(cancelled, RequestFailure::Cancelled);
+            return cancelled;
+        }
+
+        std::string streamedBody;
+        if (request.Body) {
+            streamedBody.assign(request.Body, size_t(request.BodySize));
+        } else if (request.BodyReader) {
+            char buffer[16 * 1024];
+            for (;;) {
+                size_t length = request.BodyReader(buffer, sizeof(buffer));
+                if (length == CURL_READFUNC_ABORT) {
+                    HttpResponse aborted;
+                    aborted.Error = "CURL error: " + std::string(curl_easy_strerror(CURLE_ABORTED_BY_CALLBACK));
+                    aborted.Failure = RequestFailure::Other;
+                    return aborted;
+                }
+                if (length == 0) break;
+                streamedBody.append(buffer, length);
+            }
+        }
+
+        HttpResponse response;
+        {
+            std::lock_guard<std::mutex> lock(Impl->Mutex);
+            Impl->Requests++;
+            response = Impl->Route(request, streamedBody);
+        }
+
+        if (request.ResponseSink && response.StatusCode >= 200 && response.StatusCode < 300) {
+            // Deliver in network-sized pieces so streaming consumers see realistic chunking
+            const size_t chunk = 16 * 1024;
+            for (size_t offset = 0; offset < response.Body.size(); offset += chunk) {
+                if (!request.ResponseSink(response.Body.data() + offset, std::min(chunk, response.Body.size() - offset))) {
+                    response.Error = "CURL error: " + std::string(curl_easy_strerror(CURLE_WRITE_ERROR));
+                    response.Failure = RequestFailure::Other;
+                    response.StatusCode = 0;
+                    break;
+                }
+            }
+            response.Body.clear();
+        }
+        return response;
+    }
+
+    uint64_t LoopbackTransport::GetRequestCount() const
+    {
+        std::lock_guard<std::mutex> lock(Impl->Mutex);
+        return Impl->Requests;
+    }
+
+    void LoopbackTransport::Reset()
+    {
+        std::lock_guard<std::mutex> lock(Impl->Mutex);
+        Impl->Requests = 0;
+        Impl->NextIds.clear();
+        Impl->Saves.clear();
+        Impl->Conflicts.clear();
+        Impl->Uploads.clear();
+        Impl->Wishlist.clear();
+    }
+
+    // --- Fault injection ---
+
+    namespace
+    {
+        // Sleeps until `until` in short slices. Returns why curl would have given up
+        // first, if it would: the request's token, or its total timeout counted from start.
+        RequestFailure SimulateWait(const HttpRequest& request, std::chrono::steady_clock::time_point start,
+                                    std::chrono::steady_clock::time_point until)
+        {
+            auto limit = request.Timeout.count() > 0 ? start + request.Timeout : std::chrono::steady_clock::time_point::max();
+            for (;;) {
+                if (request.Cancel.IsCancelled()) return RequestFailure::Cancelled;
+                auto now = std::chrono::steady_clock::now();
+                if (now >= until) return RequestFailure::None;
+                if (now >= limit) return RequestFailure::Timeout;
+                std::this_thread::sleep_until(std::min(std::min(until, limit), now + std::chrono::milliseconds(20)));
+            }
+        }
+
+        // Moves `bytes` at `bandwidth` bytes per second. Like curl, gives up once the rate has
+        // stayed below LowSpeedBytes for LowSpeedTime.
+        RequestFailure SimulateTransfer(const HttpRequest& request, std::chrono::steady_clock::time_point start,
+                                        size_t bytes, long bandwidth)
+        {
+            if (bandwidth <= 0 || bytes == 0) return RequestFailure::None;
+            auto now = std::chrono::steady_clock::now();
+            auto until = now + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                   std::chrono::duration<double>(double(bytes) / double(bandwidth)));
+            if (request.LowSpeedBytes > 0 && bandwidth < request.LowSpeedBytes && now + request.LowSpeedTime < until) {
+                RequestFailure failure = SimulateWait(request, start, now + request.LowSpeedTime);
+                return failure != RequestFailure::None ? failure : RequestFailure::Timeout;
+            }
+            return SimulateWait(request, start, until);
+        }
+
+        HttpResponse ConnectionReset()
+        {
+            HttpResponse response;
+            response.Error = "CURL error: " + std::string(curl_easy_strerror(CURLE_RECV_ERROR));
+            response.Failure = RequestFailure::Other;
+            return response;
+        }
+
+        enum class FaultFate { Forward, Reset, LostResponse, SlowLoris, Throttle, ServerError };
+    }
+
+    struct FaultInjectionTransport::State
+    {
+        mutable std::mutex Mutex;
+        std::mt19937_64 Random;
+        std::vector<FaultPhase> Script;     // Never empty; SetFaults makes it one phase
+        bool Loop = false;
+        std::chrono::steady_clock::time_point ScriptStart;
+        int BurstLeft = 0;                  // 503s still owed by the current burst
+        FaultInjectionStats Stats;
+
+        // Caller holds Mutex
+        const NetworkFaults& Current(std::chrono::steady_clock::time_point now) const
+        {
+            std::chrono::milliseconds total(0);
+            for (const FaultPhase& phase : Script) total += phase.Duration;
+            auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - ScriptStart);
+            if (Loop && total.count() > 0) elapsed = elapsed % total;
+            for (const FaultPhase& phase : Script) {
+                if (elapsed < phase.Duration) return phase.Faults;
+                elapsed -= phase.Duration;
+            }
+            return Script.back().Faults;
+        }
+
+        // Caller holds Mutex
+        bool Roll(double rate)
+        {
+            return rate > 0.0 && std::uniform_real_distribution<double>(0.0, 1.0)(Random) < rate;
+        }
+    };
+
+    FaultInjectionTransport::FaultInjectionTransport(std::shared_ptr<ITransport> inner, const NetworkFaults& faults, uint64_t seed)
+        : Inner(std::move(inner)), Impl(new State())
+    {
+        Impl->Random.seed(seed);
+        SetFaults(faults);
+    }
+
+    FaultInjectionTransport::~FaultInjectionTransport() {}
+
+    HttpResponse FaultInjectionTransport::Send(const HttpRequest& request)
+    {
+        auto start = std::chrono::steady_clock::now();
+
+        // Every random choice is made here, so one seed gives the same faults for the same request order
+        NetworkFaults faults;
+        auto firstByte = start;
+        FaultFate fate = FaultFate::Forward;
+        {
+            std::lock_guard<std::mutex> lock(Impl->Mutex);
+            Impl->Stats.Requests++;
+            faults = Impl->Current(start);
+            firstByte += faults.Latency;
+            if (faults.Jitter.count() > 0) {
+                firstByte += std::chrono::milliseconds(std::uniform_int_distribution<long long>(0, faults.Jitter.count())(Impl->Random));
+            }
+            if (faults.ServerErrorRate <= 0.0) Impl->BurstLeft = 0; // A burst ends with its phase
+
+            if (Impl->BurstLeft > 0) {
+                Impl->BurstLeft--;
+                fate = FaultFate::ServerError;
+            } else if (Impl->Roll(faults.ResetRate)) {
+                fate = FaultFate::Reset;
+            } else if (Impl->Roll(faults.ServerErrorRate)) {
+                Impl->BurstLeft = std::max(faults.ServerErrorBurst, 1) - 1;
+                fate = FaultFate::ServerError;
+            } else if (Impl->Roll(faults.ThrottleRate)) {
+                fate = FaultFate::Throttle;
+            } else if (Impl->Roll(faults.SlowLorisRate)) {
+                fate = FaultFate::SlowLoris;
+            } else if (Impl->Roll(faults.LostResponseRate)) {
+                fate = FaultFate::LostResponse;
+            }
+        }
+
+        auto finish = [this](HttpResponse response, FaultFate fate) -> HttpResponse {
+            std::lock_guard<std::mutex> lock(Impl->Mutex);
+            FaultInjectionStats& stats = Impl->Stats;
+            if (response.Failure == RequestFailure::Timeout) stats.TimedOut++;
+            else if (response.Failure == RequestFailure::Cancelled) stats.Cancelled++;
+            else if (fate == FaultFate::Reset) stats.Resets++;
+            else if (fate == FaultFate::LostResponse) stats.LostResponses++;
+            else if (fate == FaultFate::SlowLoris) stats.SlowLoris++;
+            else if (fate == FaultFate::Throttle) stats.Throttled++;
+            else if (fate == FaultFate::ServerError) stats.ServerErrors++;
+            return response;
+        };
+        auto fail = [&](RequestFailure failure) -> HttpResponse {
+            HttpResponse response;
+            Internal::SetRequestFailure(response, failure);
+            return finish(response, fate);
+        };
+
+        RequestFailure failure = SimulateWait(request, start, firstByte);
+        if (failure != RequestFailure::None) return fail(failure);
+        if (fate == FaultFate::Reset) return finish(ConnectionReset(), fate);
+
+        failure = SimulateTransfer(request, start, request.BodySize > 0 ? size_t(request.BodySize) : 0, faults.BandwidthBytesPerSecond);
+        if (failure != RequestFailure::None) return fail(failure);
+
+        switch (fate) {
+        case FaultFate::Throttle:
+        case FaultFate::ServerError: {
+            HttpResponse response = fate == FaultFate::Throttle ? Reply(429, R"({"error":"rate_limited"})")
+                                                                : Reply(503, R"({"error":"service_unavailable"})");
+            response.RetryAfter = faults.RetryAfter;
+            return finish(response, fate);
+        }
+        case FaultFate::SlowLoris:
+            // About a byte a second: below any low-speed limit, so that or the total timeout ends it
+            if (request.LowSpeedBytes > 0 && request.LowSpeedTime < faults.SlowLorisHold) {
+                failure = SimulateWait(request, start, std::chrono::steady_clock::now() + request.LowSpeedTime);
+                return fail(failure != RequestFailure::None ? failure : RequestFailure::Timeout);
+            }
+            failure = SimulateWait(request, start, std::chrono::steady_clock::now() + faults.SlowLorisHold);
+            if (failure != RequestFailure::None) return fail(failure);
+            return finish(ConnectionReset(), fate); // The server hung up first
+        default: break;
+        }
+
+        // A streamed response is counted on its way to the caller's sink
+        size_t streamed = 0;
+        HttpResponse response;
+        {
+            std::lock_guard<std::mutex> lock(Impl->Mutex);
+            Impl->Stats.Forwarded++;
+        }
+        if (request.ResponseSink) {
+            HttpRequest forwarded = request;
+            forwarded.ResponseSink = [&request, &streamed](const char* data, size_t size) {
+                streamed += size;
+                return request.ResponseSink(data, size);
+            };
+            response = Inner->Send(forwarded);
+        } else {
+            response = Inner->Send(request);
+        }
+        if (response.Failure != RequestFailure::None) return finish(response, FaultFate::Forward);
+        if (fate == FaultFate::LostResponse) return finish(ConnectionReset(), fate);
+
+        failure = SimulateTransfer(request, start, response.Body.size() + streamed, faults.BandwidthBytesPerSecond);
+        if (failure != RequestFailure::None) return fail(failure);
+        return finish(response, fate);
+    }
+
+    void FaultInjectionTransport::SetFaults(const NetworkFaults& faults)
+    {
+        FaultPhase phase;
+        phase.Faults = faults;
+        SetScript(std::vector<FaultPhase>(1, phase));
+    }
+
+    void FaultInjectionTransport::SetScript(const std::vector<FaultPhase>& script, bool loop)
+    {
+        std::lock_guard<std::mutex> lock(Impl->Mutex);
+        Impl->Script = script.empty() ? std::vector<FaultPhase>(1) : script;
+        Impl->Loop = loop;
+        Impl->ScriptStart = std::chrono::steady_clock::now();
+        Impl->BurstLeft = 0;
+    }
+
+    NetworkFaults FaultInjectionTransport::GetFaults() const
+    {
+        std::lock_guard<std::mutex> lock(Impl->Mutex);
+        return Impl->Current(std::chrono::steady_clock::now());
+    }
+
+    FaultInjectionStats FaultInjectionTransport::GetStats() const
+    {
+        std::lock_guard<std::mutex> lock(Impl->Mutex);
+        return Impl->Stats;
+    }
+
+    // --- Record / replay ---
+
+    RecordingTransport::RecordingTransport(std::shared_ptr<ITransport> inner) : Inner(inner) {}
+
+    HttpResponse RecordingTransport::Send(const HttpRequest& request)
+    {
+        RecordedExchange exchange;
+        exchange.Method = request.Method;
+        exchange.Url = request.Url;
+
+        // Tee streamed bodies so the recording holds exactly what was sent and received
+        HttpRequest teed = request;
+        if (request.Body) {
+            exchange.RequestBody.assign(request.Body, size_t(request.BodySize));
+        } else if (request.BodyReader) {
+            teed.BodyReader = [&exchange, &request](char* buffer, size_t size) {
+                size_t length = request.BodyReader(buffer, size);
+                if (length != CURL_READFUNC_ABORT) exchange.RequestBody.append(buffer, length);
+                return length;
+            };
+            if (request.BodyRewind) {
+                teed.BodyRewind = [&exchange, &request]() {
+                    exchange.RequestBody.clear();
+                    return request.BodyRewind();
+                };
+            }
+        }
+        if (request.ResponseSink) {
+            teed.ResponseSink = [&exchange, &request](const char* data, size_t size) {
+                exchange.ResponseBody.append(data, size);
+                return request.ResponseSink(data, size);
+            };
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        HttpResponse response = Inner->Send(teed);
+        exchange.Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        exchange.StatusCode = response.StatusCode;
+        exchange.Error = response.Error;
+        exchange.ResponseBody += response.Body;
+
+        std::lock_guard<std::mutex> lock(Mutex);
+        Exchanges.push_back(exchange);
+        return response;
+    }
+
+    std::vector<RecordedExchange> RecordingTransport::GetExchanges() const
+    {
+        std::lock_guard<std::mutex> lock(Mutex);
+        return Exchanges;
+    }
+
+    void RecordingTransport::Clear()
+    {
+        std::lock_guard<std::mutex> lock(Mutex);
+        Exchanges.clear();
+    }
+
+    ReplayTransport::ReplayTransport(const std::vector<RecordedExchange>& exchanges)
+        : Exchanges(exchanges), Used(exchanges.size(), false) {}
+
+    HttpResponse ReplayTransport::Send(const HttpRequest& request)
+    {
+        // Drain the request body like a real transport would
+        if (!request.Body && request.BodyReader) {
+            char buffer[16 * 1024];
+            size_t length;
+            while ((length = request.BodyReader(buffer, sizeof(buffer))) != 0 && length != CURL_READFUNC_ABORT) {}
+        }
+
+        HttpResponse response;
+        {
+            std::lock_guard<std::mutex> lock(Mutex);
+            size_t i = 0;
+            for (; i < Exchanges.size(); ++i) {
+                if (!Used[i] && Exchanges[i].Method == request.Method && Exchanges[i].Url == request.Url) break;
+            }
+            if (i == Exchanges.size()) {
+                response.Error = "No recorded response for " + std::string(request.Method) + " " + request.Url;
+                response.Failure = RequestFailure::Other;
+                return response;
+            }
+            Used[i] = true;
+            response.StatusCode = Exchanges[i].StatusCode;
+            response.Body = Exchanges[i].ResponseBody;
+            response.Error = Exchanges[i].Error;
+            if (!response.Error.empty()) response.Failure = RequestFailure::Other;
+        }
+
+        if (request.ResponseSink && response.StatusCode >= 200 && response.StatusCode < 300) {
+            if (!request.ResponseSink(response.Body.data(), response.Body.size())) {
+                response.Error = "CURL error: " + std::string(curl_easy_strerror(CURLE_WRITE_ERROR));
+                response.Failure = RequestFailure::Other;
+                response.StatusCode = 0;
+            }
+            response.Body.clear();
+        }
+        return response;
+    }
+
+    size_t ReplayTransport::GetUnusedCount() const
+    {
+        std::lock_guard<std::mutex> lock(Mutex);
+        size_t unused = 0;
+        for (bool used : Used) if (!used) ++unused;
+        return unused;
+    }
+
+    // --- Traffic capture ---
+
+    namespace
+    {
+        const char kTraceMagic[8] = { 'G', 'L', 'T', 'R', 'A', 'C', 'E', '1' };
+
+        void PutVarint(std::string& out, uint64_t value)
+        {
+            while (value >= 0x80) {
+                out += char((value & 0x7f) | 0x80);
+                value >>= 7;
+            }
+            out += char(value);
+        }
+
+        void PutString(std::string& out, const std::string& value)
+        {
+            PutVarint(out, value.size());
+            out += value;
+        }
+
+        bool GetVarint(std::FILE* file, uint64_t& value)
+        {
+            value = 0;
+            for (int shift = 0; shift < 64; shift += 7) {
+                int c = std::fgetc(file);
+                if (c == EOF) return false;
+                value |= uint64_t(c & 0x7f) << shift;
+                if (!(c & 0x80)) return true;
+            }
+            return false;
+        }
+
+        bool GetString(std::FILE* file, std::string& value)
+        {
+            uint64_t length = 0;
+            if (!GetVarint(file, length) || length > (uint64_t(1) << 32)) return false;
+            value.resize(size_t(length));
+            return length == 0 || std::fread(&value[0], 1, size_t(length), file) == length;
+        }
+
+        std::mutex g_captureMutex;
+        std::shared_ptr<TraceCaptureTransport> g_capture;
+    }
+
+    TraceCaptureTransport::TraceCaptureTransport(std::shared_ptr<ITransport> inner, const std::string& path)
+        : Inner(inner), Start(std::chrono::steady_clock::now())
+    {
+        File = std::fopen(path.c_str(), "wb");
+        if (File) std::fwrite(kTraceMagic, 1, sizeof(kTraceMagic), File);
+    }
+
+    TraceCaptureTransport::~TraceCaptureTransport()
+    {
+        if (File) std::fclose(File);
+    }
+
+    HttpResponse TraceCaptureTransport::Send(const HttpRequest& request)
+    {
+        std::string body = request.Body ? std::string(request.Body, size_t(request.BodySize)) : std::string();
+        uint64_t responseBytes = 0;
+
+        HttpRequest teed = request;
+        if (!request.Body && request.BodyReader) {
+            teed.BodyReader = [&body, &request](char* buffer, size_t size) {
+                size_t length = request.BodyReader(buffer, size);
+                if (length != CURL_READFUNC_ABORT) body.append(buffer, length);
+                return length;
+            };
+            if (request.BodyRewind) {
+                teed.BodyRewind = [&body, &request]() {
+                    body.clear();
+                    return request.BodyRewind();
+                };
+            }
+        }
+        if (request.ResponseSink) {
+            teed.ResponseSink = [&responseBytes, &request](const char* data, size_t size) {
+                responseBytes += size;
+                return request.ResponseSink(data, size);
+            };
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        HttpResponse response = Inner->Send(teed);
+        auto end = std::chrono::steady_clock::now();
+        responseBytes += response.Body.size();
+
+        // Encode outside the lock; only the write is serialized
+        std::string record;
+        PutVarint(record, uint64_t(std::chrono::duration_cast<std::chrono::microseconds>(start - Start).count()));
+        PutVarint(record, uint64_t(std::chrono::duration_cast<std::chrono::microseconds>(end - start).count()));
+        PutString(record, request.Method);
+        PutString(record, request.Url);
+        size_t headerCount = 0;
+        for (const curl_slist* header = request.Headers; header; header = header->next) ++headerCount;
+        PutVarint(record, headerCount);
+        for (const curl_slist* header = request.Headers; header; header = header->next) {
+            if (strncmp(header->data, "Authorization:", 14) == 0) PutString(record, "Authorization: Bearer <redacted>");
+            else PutString(record, header->data);
+        }
+        PutString(record, body);
+        PutVarint(record, uint64_t(response.StatusCode));
+        PutVarint(record, responseBytes);
+
+        std::lock_guard<std::mutex> lock(Mutex);
+        if (File) {
+            std::fwrite(record.data(), 1, record.size(), File);
+            Records++;
+        }
+        return response;
+    }
+
+    bool TraceCaptureTransport::IsOpen() const
+    {
+        return File != nullptr;
+    }
+
+    uint64_t TraceCaptureTransport::GetRecordCount() const
+    {
+        std::lock_guard<std::mutex> lock(Mutex);
+        return Records;
+    }
+
+    bool StartTrafficCapture(const std::string& path)
+    {
+        std::lock_guard<std::mutex> lock(g_captureMutex);
+        std::shared_ptr<ITransport> inner = g_capture ? g_capture->GetInner() : GetTransport();
+        std::shared_ptr<TraceCaptureTransport> capture = std::make_shared<TraceCaptureTransport>(inner, path);
+        if (!capture->IsOpen()) return false;
+        g_capture = capture;
+        SetTransport(capture);
+        return true;
+    }
+
+    void StopTrafficCapture()
+    {
+        std::lock_guard<std::mutex> lock(g_captureMutex);
+        if (!g_capture) return;
+        SetTransport(g_capture->GetInner());
+        g_capture.reset(); // The file is closed once in-flight requests release it
+    }
+
+    bool ReadTrafficTrace(const std::string& path, std::vector<TraceRecord>& records)
+    {
+        records.clear();
+        std::FILE* file = std::fopen(path.c_str(), "rb");
+        if (!file) return false;
+
+        char magic[sizeof(kTraceMagic)];
+        bool ok = std::fread(magic, 1, sizeof(magic), file) == sizeof(magic) && memcmp(magic, kTraceMagic, sizeof(magic)) == 0;
+        while (ok) {
+            TraceRecord record;
+            uint64_t value = 0;
+            if (!GetVarint(file, record.OffsetMicros)) break; // Clean end of file
+            uint64_t headerCount = 0;
+            ok = GetVarint(file, record.DurationMicros) && GetString(file, record.Method) && GetString(file, record.Url) &&
+                 GetVarint(file, headerCount);
+            for (uint64_t i = 0; ok && i < headerCount; ++i) {
+                std::string header;
+                ok = GetString(file, header);
+                record.Headers.push_back(header);
+            }
+            ok = ok && GetString(file, record.RequestBody) && GetVarint(file, value) && GetVarint(file, record.ResponseBytes);
+            record.StatusCode = long(value);
+            if (ok) records.push_back(record);
+        }
+
+        std::fclose(file);
+        return ok;
+    }
+
+    // --- Active transport ---
+
+    namespace
+    {
+        std::shared_ptr<ITransport>& TransportSlot()
+        {
+            static std::shared_ptr<ITransport> transport = std::make_shared<CurlTransport>();
+            return transport;
+        }
+    }
+
+    void SetTransport(std::shared_ptr<ITransport> transport)
+    {
+        if (!transport) transport = std::make_shared<CurlTransport>();
+        std::atomic_store(&TransportSlot(), transport);
+    }
+
+    std::shared_ptr<ITransport> GetTransport()
+    {
+        return std::atomic_load(&TransportSlot());
+    }
+
+} // namespace GlitchSDK
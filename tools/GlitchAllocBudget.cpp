@@ -0,0 +1,244 @@
+// GlitchAllocBudget.cpp - Heap allocation budgets for the public API
+//
+// Replaces the global allocator with a counting one, runs each entry point against a
+// transport that answers without allocating, and compares allocations and bytes per
+// call with the budgets below. Soak checks repeat a call many times with changing
+// inputs and bound how much the live heap grows. Exits non-zero if any budget is
+// exceeded, so it can gate builds. When an increase is intended, raise the budget in
+// the same change.
+
+#include "GlitchSDK.h"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete" // new is replaced below, so malloc/free do match
+#endif
+
+namespace
+{
+    std::atomic<uint64_t> g_allocations(0);
+    std::atomic<uint64_t> g_bytes(0);
+    std::atomic<int64_t> g_liveBytes(0);
+
+    // Each block starts with its size, so delete can keep g_liveBytes; 16 bytes keeps malloc's alignment
+    const std::size_t kHeader = 16;
+}
+
+void* operator new(std::size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    g_bytes.fetch_add(size, std::memory_order_relaxed);
+    g_liveBytes.fetch_add(int64_t(size), std::memory_order_relaxed);
+    if (char* p = (char*)std::malloc(size + kHeader)) {
+        *(std::size_t*)p = size;
+        return p + kHeader;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+    if (!p) return;
+    char* block = (char*)p - kHeader;
+    g_liveBytes.fetch_sub(int64_t(*(std::size_t*)block), std::memory_order_relaxed);
+    std::free(block);
+}
+
+void operator delete(void* p, std::size_t) noexcept { operator delete(p); }
+void* operator new[](std::size_t size) { return operator new(size); }
+void operator delete[](void* p) noexcept { operator delete(p); }
+void operator delete[](void* p, std::size_t) noexcept { operator delete(p); }
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    try { return operator new(size); } catch (...) { return nullptr; }
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    try { return operator new(size); } catch (...) { return nullptr; }
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept { operator delete(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { operator delete(p); }
+
+namespace
+{
+    // Answers every request with a small-string body, so only the SDK's own allocations are counted
+    class NullTransport : public GlitchSDK::ITransport
+    {
+    public:
+        GlitchSDK::HttpResponse Send(const GlitchSDK::HttpRequest& request) override
+        {
+            if (!request.Body && request.BodyReader) {
+                char buffer[4096];
+                while (request.BodyReader(buffer, sizeof(buffer)) - 1 < sizeof(buffer)) {}
+            }
+            GlitchSDK::HttpResponse response;
+            response.StatusCode = 201;
+            response.Body = "{}";
+            return response;
+        }
+    };
+
+    struct Budget
+    {
+        const char* Name;
+        double MaxAllocations;
+        double MaxBytes;
+    };
+
+    struct Usage
+    {
+        double Allocations;
+        double Bytes;
+    };
+
+    // Average usage of one call; the first call is discarded to skip one-time setup
+    template <typename Fn>
+    Usage Measure(Fn fn, int iterations = 20)
+    {
+        fn();
+        uint64_t allocations = g_allocations.load();
+        uint64_t bytes = g_bytes.load();
+        for (int i = 0; i < iterations; ++i) fn();
+        return Usage{ double(g_allocations.load() - allocations) / iterations, double(g_bytes.load() - bytes) / iterations };
+    }
+
+    int g_failures = 0;
+
+    // Live heap growth over `calls` more calls, after `warmup` calls have filled any caches
+    template <typename Fn>
+    void Soak(const char* name, double maxGrowthBytes, Fn fn, int warmup = 1000, int calls = 20000)
+    {
+        int call = 0;
+        for (; call < warmup; ++call) fn(call);
+        int64_t before = g_liveBytes.load();
+        for (; call < warmup + calls; ++call) fn(call);
+        double growth = double(g_liveBytes.load() - before);
+        bool ok = growth <= maxGrowthBytes;
+        if (!ok) g_failures++;
+        std::printf("%-4s %-40s live heap growth over %d calls %10.0f / %.0f bytes\n", ok ? "ok" : "FAIL",
+                    name, calls, growth, maxGrowthBytes);
+    }
+
+    void Check(const Budget& budget, const Usage& usage)
+    {
+        bool ok = usage.Allocations <= budget.MaxAllocations && usage.Bytes <= budget.MaxBytes;
+        if (!ok) g_failures++;
+        std::printf("%-4s %-40s allocs %8.1f / %-8.0f bytes %10.0f / %.0f\n", ok ? "ok" : "FAIL",
+                    budget.Name, usage.Allocations, budget.MaxAllocations, usage.Bytes, budget.MaxBytes);
+    }
+}
+
+int main()
+{
+    const std::string token = "budget-token";
+    const std::string titleId = "00000000-0000-0000-0000-000000000001";
+    const std::string installId = "00000000-0000-0000-0000-000000000002";
+    GlitchSDK::SetTransport(std::make_shared<NullTransport>());
+
+    GlitchSDK::FingerprintComponents fingerprint;
+    fingerprint.DeviceModel = "Budget Desktop";
+    fingerprint.DeviceType = "desktop";
+    fingerprint.OSName = "Windows";
+    fingerprint.OSVersion = "10.0.22621";
+    fingerprint.DisplayResolution = "1920x1080";
+    fingerprint.CPUModel = "Intel i7 12700H (14-core)";
+    fingerprint.CPUCores = 14;
+    fingerprint.GPUModel = "NVIDIA RTX 3060 6GB";
+    fingerprint.MemoryMB = 16384;
+    fingerprint.Language = "en-US";
+    fingerprint.Timezone = "America/New_York";
+    fingerprint.FormFactors.push_back("Desktop");
+    fingerprint.KeyboardLayout["KeyQ"] = "q";
+    fingerprint.KeyboardLayout["KeyW"] = "w";
+
+    GlitchSDK::PurchaseData purchase(installId);
+    purchase.PurchaseType = "in_app";
+    purchase.PurchaseAmount = 4.99f;
+    purchase.Currency = "USD";
+    purchase.TransactionID = "txn_0123456789";
+    purchase.ItemSKU = "gem_pack_small";
+    purchase.ItemName = "Small Gem Pack";
+
+    GlitchSDK::GameEventData event;
+    event.GameInstallID = installId;
+    event.StepKey = "prologue";
+    event.ActionKey = "item_crafted";
+    event.MetadataJSON = R"({"item":"sword","tier":2})";
+    event.EventTimestamp = "2024-01-01T00:00:00Z";
+    std::vector<GlitchSDK::GameEventData> oneEvent(1, event);
+    std::vector<GlitchSDK::GameEventData> manyEvents(101, event);
+
+    GlitchSDK::GameSaveData save;
+    save.SlotIndex = 1;
+    save.ClientTimestamp = "2024-01-01T00:00:00Z";
+    std::string megabyte(1024 * 1024, 'x');
+    GlitchSDK::GameSaveData smallSave = save;
+    smallSave.PayloadBase64 = std::string(4096, 'A');
+
+    // Never drains on its own during a measurement: no flush interval or full batch comes due
+    GlitchSDK::ClientConfig clientConfig;
+    clientConfig.TitleToken = token;
+    clientConfig.TitleId = titleId;
+    clientConfig.FlushIntervalMs = 3600 * 1000;
+    clientConfig.MaxBatchEvents = 1000000;
+    clientConfig.MaxQueuedEvents = 1000000;
+
+    Check({ "CreateInstallRecord", 6, 512 },
+          Measure([&] { GlitchSDK::CreateInstallRecord(token, titleId, installId, "steam"); }));
+    Check({ "CreateInstallRecordWithFingerprint", 12, 1280 },
+          Measure([&] { GlitchSDK::CreateInstallRecordWithFingerprint(token, titleId, installId, "steam", fingerprint, "1.0.0"); }));
+    Check({ "RecordPurchase", 8, 1408 },
+          Measure([&] { GlitchSDK::RecordPurchase(token, titleId, purchase); }));
+    Check({ "RecordEvent", 4, 512 },
+          Measure([&] { GlitchSDK::RecordEvent(token, titleId, event); }));
+
+    // 201 is cached for the default TTL, so after the first call every call is a hit
+    Check({ "ValidateInstall (cache hit)", 8, 512 },
+          Measure([&] { GlitchSDK::ValidateInstall(token, titleId, installId); }));
+    GlitchSDK::SetValidateInstallCacheTTL(0);
+    Check({ "ValidateInstall (cache miss)", 16, 1536 },
+          Measure([&] { GlitchSDK::ValidateInstall(token, titleId, installId); }));
+    GlitchSDK::SetValidateInstallCacheTTL(60);
+
+    {
+        GlitchSDK::Client client(clientConfig);
+        Check({ "Client::QueueEvent", 8, 512 },
+              Measure([&] { client.QueueEvent(event); }));
+        // Purchases are sent at once, so this covers the send; Flush() waits for it
+        Check({ "Client::QueuePurchase (queued and sent)", 16, 2048 },
+              Measure([&] { client.QueuePurchase(purchase); client.Flush(); }));
+    }
+
+    Usage one = Measure([&] { GlitchSDK::RecordEventsBulk(token, titleId, oneEvent); });
+    Usage many = Measure([&] { GlitchSDK::RecordEventsBulk(token, titleId, manyEvents); });
+    Check({ "RecordEventsBulk (per event)", 1, 256 },
+          Usage{ (many.Allocations - one.Allocations) / 100, (many.Bytes - one.Bytes) / 100 });
+
+    Check({ "FingerprintToJSON", 8, 1536 },
+          Measure([&] { GlitchSDK::FingerprintToJSON(fingerprint); }));
+    Check({ "PurchaseToJSON", 6, 1216 },
+          Measure([&] { GlitchSDK::PurchaseToJSON(purchase); }));
+    Check({ "StoreSave (4 KB payload)", 16, 32 * 1024 },
+          Measure([&] { GlitchSDK::StoreSave(token, titleId, installId, smallSave); }));
+    Check({ "StoreSaveRaw (per MB)", 16, 2.0 * 1024 * 1024 },
+          Measure([&] { GlitchSDK::StoreSaveRaw(token, titleId, installId, save, megabyte.data(), megabyte.size()); }, 5));
+    Check({ "ToggleWishlist", 4, 256 },
+          Measure([&] { GlitchSDK::ToggleWishlist(token, titleId); }));
+    Check({ "UpdateWishlistScore", 4, 256 },
+          Measure([&] { GlitchSDK::UpdateWishlistScore(token, titleId, 42); }));
+
+    // Every player sends a different JWT, and JWTs rotate, so per-token state must not pile up
+    Soak("ToggleWishlist (rotating JWTs)", 16 * 1024,
+         [&](int call) { GlitchSDK::ToggleWishlist("user-jwt-" + std::to_string(call), titleId); });
+    Soak("UpdateWishlistScore (rotating JWTs)", 16 * 1024,
+         [&](int call) { GlitchSDK::UpdateWishlistScore("score-jwt-" + std::to_string(call), titleId, call % 100); });
+
+    std::printf("%d budget(s) exceeded\n", g_failures);
+    return g_failures == 0 ? 0 : 1;
+}
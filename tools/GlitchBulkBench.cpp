@@ -0,0 +1,111 @@
+// GlitchBulkBench.cpp - RecordEventsBulk serialization throughput by executor size
+//
+//   GlitchBulkBench --events 500000 --runs 5
+//
+// Serializes one large batch on executors of 1, 2, 4, ... threads up to the core count and
+// reports the best run for each. The request body is drained and hashed by a transport that
+// does no I/O, so the timing is serialization plus body streaming. Exits non-zero if any
+// executor size produced a different body than the single-threaded run.
+
+#include "GlitchSDK.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+namespace
+{
+    // Drains the body like a real transport and remembers its size and FNV-1a hash
+    class HashingTransport : public GlitchSDK::ITransport
+    {
+    public:
+        GlitchSDK::HttpResponse Send(const GlitchSDK::HttpRequest& request) override
+        {
+            Hash = 1469598103934665603ULL;
+            Bytes = 0;
+            if (request.Body) {
+                Add(request.Body, size_t(request.BodySize));
+            } else if (request.BodyReader) {
+                char buffer[64 * 1024];
+                size_t length;
+                while ((length = request.BodyReader(buffer, sizeof(buffer))) != 0 && length != CURL_READFUNC_ABORT) Add(buffer, length);
+            }
+            GlitchSDK::HttpResponse response;
+            response.StatusCode = 201;
+            response.Body = "{}";
+            return response;
+        }
+
+        uint64_t Hash = 0;
+        size_t Bytes = 0;
+
+    private:
+        void Add(const char* data, size_t size)
+        {
+            for (size_t i = 0; i < size; ++i) Hash = (Hash ^ (unsigned char)data[i]) * 1099511628211ULL;
+            Bytes += size;
+        }
+    };
+}
+
+int main(int argc, char** argv)
+{
+    size_t eventCount = 500000;
+    int runs = 5;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "--events") == 0) eventCount = size_t(std::strtoull(argv[i + 1], nullptr, 10));
+        else if (strcmp(argv[i], "--runs") == 0) runs = std::max(1, std::atoi(argv[i + 1]));
+    }
+
+    std::vector<GlitchSDK::GameEventData> events(eventCount);
+    for (size_t i = 0; i < events.size(); ++i) {
+        events[i].GameInstallID = "00000000-0000-0000-0000-000000000002";
+        events[i].StepKey = "level_" + std::to_string(i % 40);
+        events[i].ActionKey = i % 3 == 0 ? "enemy \"boss\" defeated" : "item_crafted";
+        events[i].MetadataJSON = R"({"seq":)" + std::to_string(i) + R"(,"tier":2})";
+    }
+
+    std::shared_ptr<HashingTransport> transport = std::make_shared<HashingTransport>();
+    GlitchSDK::SetTransport(transport);
+
+    unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<unsigned> threadCounts;
+    for (unsigned threads = 1; threads < cores; threads *= 2) threadCounts.push_back(threads);
+    threadCounts.push_back(cores);
+
+    std::printf("%zu events, best of %d runs\n", eventCount, runs);
+    std::printf("%8s %10s %14s %10s %8s\n", "threads", "ms", "events/s", "MB/s", "speedup");
+
+    double baselineSeconds = 0.0;
+    uint64_t baselineHash = 0;
+    int mismatches = 0;
+    for (unsigned threads : threadCounts) {
+        GlitchSDK::ExecutorConfig config;
+        config.Threads = threads;
+        config.Priority = GlitchSDK::ThreadPriority::Normal;
+        GlitchSDK::SetExecutor(std::make_shared<GlitchSDK::WorkStealingExecutor>(config));
+
+        double best = 0.0;
+        for (int run = 0; run < runs; ++run) {
+            auto start = std::chrono::steady_clock::now();
+            GlitchSDK::RecordEventsBulk("bench-token", "00000000-0000-0000-0000-000000000001", events);
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            if (run == 0 || seconds < best) best = seconds;
+        }
+
+        if (threads == 1) {
+            baselineSeconds = best;
+            baselineHash = transport->Hash;
+        } else if (transport->Hash != baselineHash) {
+            mismatches++;
+            std::printf("body mismatch with %u threads\n", threads);
+        }
+        std::printf("%8u %10.1f %14.0f %10.1f %7.2fx\n", threads, best * 1000.0, double(eventCount) / best,
+                    double(transport->Bytes) / (1024.0 * 1024.0) / best, baselineSeconds / best);
+    }
+
+    GlitchSDK::SetExecutor(nullptr);
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,228 @@
+// GlitchReplay.cpp - Replays a captured traffic trace against the in-process loopback server
+//
+// Requests go back through the SDK rather than straight to the transport: bulk event batches are
+// rebuilt and sent with TitleContext::SendEventsBulk, other title-scoped calls with TitleContext::Send,
+// and anything else with Internal::SendRequest. Serialization, timeouts, tracing and metrics all run,
+// so a regression in any of them shows up in the numbers.
+//
+// Capture a trace in the game with GlitchSDK::StartTrafficCapture("session.gltrace"), then:
+//
+//   GlitchReplay session.gltrace --speed 10 --threads 8 --report new.txt --baseline old.txt
+//
+// Requests are issued at their recorded offsets divided by --speed (1-100). The report is a
+// key=value file; when a baseline report from another SDK build is given, the deltas are printed.
+
+#include "GlitchSDK.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <thread>
+
+namespace
+{
+    struct ReplayStats
+    {
+        size_t Requests = 0;
+        size_t TransportErrors = 0;
+        size_t StatusMismatches = 0;    // Loopback answered differently than the recorded server
+        double Seconds = 0.0;
+        std::vector<double> LatencyMicros;
+        double MeanLagMicros = 0.0;     // How far behind schedule requests were issued
+    };
+
+    double Percentile(std::vector<double> values, double p)
+    {
+        if (values.empty()) return 0.0;
+        std::sort(values.begin(), values.end());
+        return values[std::min(values.size() - 1, size_t(p * values.size()))];
+    }
+
+    // Title id from an API URL (.../titles/{id}/...); empty if the URL is not title-scoped
+    std::string TitleIdFromUrl(const std::string& url)
+    {
+        static const char kTitles[] = "/titles/";
+        size_t start = url.find(kTitles);
+        if (start == std::string::npos) return std::string();
+        start += sizeof(kTitles) - 1;
+        size_t end = url.find('/', start);
+        return url.substr(start, end == std::string::npos ? std::string::npos : end - start);
+    }
+
+    // Events of a recorded bulk body, so the batch is serialized again by the SDK under test
+    bool ParseBulkEvents(const std::string& body, std::vector<GlitchSDK::GameEventData>& events)
+    {
+        std::vector<std::string> items;
+        if (!GlitchSDK::Internal::ExtractJSONArray(body, "events", items)) return false;
+        events.resize(items.size());
+        for (size_t i = 0; i < items.size(); ++i) {
+            GlitchSDK::GameEventData& event = events[i];
+            if (!GlitchSDK::Internal::ExtractJSONString(items[i], "game_install_id", event.GameInstallID) ||
+                !GlitchSDK::Internal::ExtractJSONString(items[i], "step_key", event.StepKey) ||
+                !GlitchSDK::Internal::ExtractJSONString(items[i], "action_key", event.ActionKey)) return false;
+
+            // Metadata is written last, as raw JSON
+            static const char kMetadata[] = ",\"metadata\":";
+            size_t metadata = items[i].find(kMetadata);
+            event.MetadataJSON.clear();
+            if (metadata != std::string::npos) {
+                metadata += sizeof(kMetadata) - 1;
+                event.MetadataJSON = items[i].substr(metadata, items[i].size() - 1 - metadata);
+            }
+        }
+        return true;
+    }
+
+    // Issue one recorded request through the SDK; returns the status, 0 on transport failure
+    long Issue(const GlitchSDK::TraceRecord& record, curl_slist* headers)
+    {
+        std::string titleId = TitleIdFromUrl(record.Url);
+        bool post = record.Method == "POST";
+        if (!titleId.empty() && (post || record.Method == "GET")) {
+            std::shared_ptr<const GlitchSDK::TitleContext> context = GlitchSDK::TitleContext::Get("replay", titleId);
+            std::vector<GlitchSDK::GameEventData> events;
+            if (post && record.Url == context->EventsBulkUrl() && ParseBulkEvents(record.RequestBody, events)) {
+                return context->SendEventsBulk(events).StatusCode;
+            }
+            long status = 0;
+            context->Send(record.Url, post ? &record.RequestBody : nullptr, &status);
+            return status;
+        }
+
+        GlitchSDK::HttpRequest request;
+        request.Method = record.Method.c_str();
+        request.Url = record.Url;
+        request.Headers = headers;
+        if (record.Method != "GET") request.SetBody(record.RequestBody.data(), record.RequestBody.size());
+        GlitchSDK::HttpResponse response = GlitchSDK::Internal::SendRequest(request, GlitchSDK::Endpoint::Installs);
+        return response.Error.empty() ? response.StatusCode : 0;
+    }
+
+    ReplayStats Replay(const std::vector<GlitchSDK::TraceRecord>& records, double speed, int threads)
+    {
+        // Rebuild the header lists once for requests that are not title-scoped; the capture redacts credentials
+        std::vector<curl_slist*> headers(records.size(), nullptr);
+        for (size_t i = 0; i < records.size(); ++i) {
+            for (const std::string& header : records[i].Headers) {
+                if (header.compare(0, 14, "Authorization:") == 0) headers[i] = curl_slist_append(headers[i], "Authorization: Bearer replay");
+                else headers[i] = curl_slist_append(headers[i], header.c_str());
+            }
+        }
+
+        ReplayStats stats;
+        stats.Requests = records.size();
+        stats.LatencyMicros.resize(records.size());
+        std::vector<double> lag(records.size());
+        std::atomic<size_t> next(0);
+        std::atomic<size_t> transportErrors(0);
+        std::atomic<size_t> mismatches(0);
+
+        auto start = std::chrono::steady_clock::now();
+        auto worker = [&]() {
+            for (size_t i = next.fetch_add(1); i < records.size(); i = next.fetch_add(1)) {
+                const GlitchSDK::TraceRecord& record = records[i];
+                auto due = start + std::chrono::microseconds(uint64_t(record.OffsetMicros / speed));
+                std::this_thread::sleep_until(due);
+
+                auto sent = std::chrono::steady_clock::now();
+                long status = Issue(record, headers[i]);
+                auto done = std::chrono::steady_clock::now();
+
+                stats.LatencyMicros[i] = std::chrono::duration<double, std::micro>(done - sent).count();
+                lag[i] = std::chrono::duration<double, std::micro>(sent - due).count();
+                if (status == 0) transportErrors++;
+                else if (status != record.StatusCode) mismatches++;
+            }
+        };
+
+        std::vector<std::thread> pool;
+        for (int i = 0; i < threads; ++i) pool.push_back(std::thread(worker));
+        for (std::thread& thread : pool) thread.join();
+        stats.Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        for (double value : lag) stats.MeanLagMicros += value;
+        if (!lag.empty()) stats.MeanLagMicros /= double(lag.size());
+        stats.TransportErrors = transportErrors;
+        stats.StatusMismatches = mismatches;
+        for (curl_slist* list : headers) curl_slist_free_all(list);
+        return stats;
+    }
+
+    std::map<std::string, double> Summarize(const ReplayStats& stats)
+    {
+        std::map<std::string, double> report;
+        report["requests"] = double(stats.Requests);
+        report["transport_errors"] = double(stats.TransportErrors);
+        report["status_mismatches"] = double(stats.StatusMismatches);
+        report["seconds"] = stats.Seconds;
+        report["requests_per_second"] = stats.Seconds > 0 ? double(stats.Requests) / stats.Seconds : 0.0;
+        report["latency_p50_us"] = Percentile(stats.LatencyMicros, 0.50);
+        report["latency_p95_us"] = Percentile(stats.LatencyMicros, 0.95);
+        report["latency_p99_us"] = Percentile(stats.LatencyMicros, 0.99);
+        report["latency_max_us"] = Percentile(stats.LatencyMicros, 1.0);
+        report["schedule_lag_mean_us"] = stats.MeanLagMicros;
+        return report;
+    }
+
+    bool LoadReport(const std::string& path, std::map<std::string, double>& report)
+    {
+        std::ifstream file(path.c_str());
+        if (!file.is_open()) return false;
+        std::string line;
+        while (std::getline(file, line)) {
+            size_t equals = line.find('=');
+            if (equals != std::string::npos) report[line.substr(0, equals)] = std::atof(line.c_str() + equals + 1);
+        }
+        return true;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2) {
+        std::cerr << "Usage: GlitchReplay <trace> [--speed 1-100] [--threads N] [--report out.txt] [--baseline report.txt]" << std::endl;
+        return 2;
+    }
+
+    std::string tracePath = argv[1];
+    std::string reportPath, baselinePath;
+    double speed = 1.0;
+    int threads = 4;
+    for (int i = 2; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "--speed") == 0) speed = std::max(1.0, std::min(100.0, std::atof(argv[i + 1])));
+        else if (strcmp(argv[i], "--threads") == 0) threads = std::max(1, std::atoi(argv[i + 1]));
+        else if (strcmp(argv[i], "--report") == 0) reportPath = argv[i + 1];
+        else if (strcmp(argv[i], "--baseline") == 0) baselinePath = argv[i + 1];
+    }
+
+    std::vector<GlitchSDK::TraceRecord> records;
+    if (!GlitchSDK::ReadTrafficTrace(tracePath, records) && records.empty()) {
+        std::cerr << "Failed to read trace: " << tracePath << std::endl;
+        return 1;
+    }
+
+    GlitchSDK::SetTransport(std::make_shared<GlitchSDK::LoopbackTransport>());
+    std::map<std::string, double> report = Summarize(Replay(records, speed, threads));
+
+    std::map<std::string, double> baseline;
+    bool haveBaseline = !baselinePath.empty() && LoadReport(baselinePath, baseline);
+    std::cout << "Replayed " << records.size() << " requests at " << speed << "x on " << threads << " threads" << std::endl;
+    for (const auto& entry : report) {
+        std::cout << "  " << entry.first << " = " << entry.second;
+        auto previous = baseline.find(entry.first);
+        if (haveBaseline && previous != baseline.end() && previous->second != 0) {
+            std::cout << "  (" << (entry.second - previous->second) / previous->second * 100.0 << "% vs baseline)";
+        }
+        std::cout << std::endl;
+    }
+
+    if (!reportPath.empty()) {
+        std::ofstream file(reportPath.c_str(), std::ios::trunc);
+        for (const auto& entry : report) file << entry.first << "=" << entry.second << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,258 @@
+// GlitchResilienceBench.cpp - Telemetry Client delivery under scripted network faults
+//
+//   GlitchResilienceBench --rate 2000 --fault-seconds 3 --scenario outage
+//
+// Each scenario queues events into a Client at --rate per second while a FaultInjectionTransport
+// in front of the loopback server runs a script: one clean second, the fault for --fault-seconds,
+// then clean again. It reports:
+//   delivered  events the server confirmed, as a share of those queued
+//   fault ev/s confirmed events per second while the fault was active
+//   peak queue largest Client queue seen, and its growth rate during the fault
+//   amp        event sends per confirmed event (retry amplification)
+//   recovery   time from the end of the fault until the queue is back to its pre-fault size
+// Exits non-zero if a scenario cannot account for every queued event.
+
+#include "GlitchSDK.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+namespace
+{
+    struct Scenario
+    {
+        const char* Name = "";
+        GlitchSDK::NetworkFaults Faults;
+        std::chrono::milliseconds EventsTimeout{0}; // Total timeout for /events during the run; 0 keeps the default
+    };
+
+    struct Options
+    {
+        int Rate = 2000;
+        int FaultSeconds = 3;
+        int CooldownSeconds = 2;        // Events keep coming this long after the fault
+        int MaxWaitSeconds = 30;        // Longest to wait for the queue to empty afterwards
+        int FlushIntervalMs = 100;
+        int MaxEventAttempts = GlitchSDK::ClientConfig().MaxEventAttempts;
+        uint64_t Seed = 1;
+    };
+
+    std::vector<Scenario> MakeScenarios()
+    {
+        std::vector<Scenario> scenarios;
+        Scenario scenario;
+        scenario.Name = "clean";
+        scenarios.push_back(scenario);
+
+        scenario = Scenario();
+        scenario.Name = "latency";
+        scenario.Faults.Latency = std::chrono::milliseconds(150);
+        scenario.Faults.Jitter = std::chrono::milliseconds(100);
+        scenario.Faults.BandwidthBytesPerSecond = 64 * 1024;
+        scenarios.push_back(scenario);
+
+        scenario = Scenario();
+        scenario.Name = "resets";
+        scenario.Faults.Latency = std::chrono::milliseconds(20);
+        scenario.Faults.ResetRate = 0.3;
+        scenario.Faults.LostResponseRate = 0.1;
+        scenarios.push_back(scenario);
+
+        scenario = Scenario();
+        scenario.Name = "throttle";
+        scenario.Faults.ThrottleRate = 0.7;
+        scenario.Faults.RetryAfter = std::chrono::seconds(1);
+        scenarios.push_back(scenario);
+
+        scenario = Scenario();
+        scenario.Name = "5xx-bursts";
+        scenario.Faults.ServerErrorRate = 0.1;
+        scenario.Faults.ServerErrorBurst = 10;
+        scenarios.push_back(scenario);
+
+        scenario = Scenario();
+        scenario.Name = "outage";
+        scenario.Faults.ServerErrorRate = 1.0;
+        scenarios.push_back(scenario);
+
+        scenario = Scenario();
+        scenario.Name = "slow-loris";
+        scenario.EventsTimeout = std::chrono::milliseconds(1000);
+        scenario.Faults.SlowLorisRate = 0.5;
+        scenarios.push_back(scenario);
+        return scenarios;
+    }
+
+    struct Result
+    {
+        size_t Offered = 0;
+        uint64_t Accepted = 0;
+        uint64_t AcceptedDuringFault = 0;
+        uint64_t Retried = 0;
+        uint64_t DeadLettered = 0;
+        uint64_t Dropped = 0;
+        size_t Lost = 0;                // Still unsent at the end
+        size_t PeakQueue = 0;
+        double GrowthPerSecond = 0.0;   // Queue growth over the fault
+        uint64_t PeakQueueBytes = 0;
+        double RecoveryMs = -1.0;       // Negative: never recovered
+        GlitchSDK::FaultInjectionStats Faults;
+    };
+
+    Result Run(const Scenario& scenario, const Options& options)
+    {
+        using Clock = std::chrono::steady_clock;
+        const std::chrono::milliseconds warmup(1000);
+        const std::chrono::milliseconds fault(options.FaultSeconds * 1000);
+
+        std::vector<GlitchSDK::FaultPhase> script(3);
+        script[0].Duration = warmup;
+        script[1].Duration = fault;
+        script[1].Faults = scenario.Faults;
+        std::shared_ptr<GlitchSDK::FaultInjectionTransport> transport = std::make_shared<GlitchSDK::FaultInjectionTransport>(
+            std::make_shared<GlitchSDK::LoopbackTransport>(), GlitchSDK::NetworkFaults(), options.Seed);
+        GlitchSDK::SetTransport(transport);
+
+        GlitchSDK::TimeoutPolicy savedPolicy = GlitchSDK::GetTimeoutPolicy(GlitchSDK::Endpoint::Events);
+        if (scenario.EventsTimeout.count() > 0) {
+            GlitchSDK::TimeoutPolicy policy = savedPolicy;
+            policy.Total = scenario.EventsTimeout;
+            GlitchSDK::SetTimeoutPolicy(GlitchSDK::Endpoint::Events, policy);
+        }
+
+        GlitchSDK::ClientConfig config;
+        config.TitleToken = "bench-token";
+        config.TitleId = "00000000-0000-0000-0000-000000000001";
+        config.MaxBatchEvents = 200;
+        config.FlushIntervalMs = options.FlushIntervalMs;
+        config.MaxEventAttempts = options.MaxEventAttempts;
+        std::unique_ptr<GlitchSDK::Client> client(new GlitchSDK::Client(config));
+
+        GlitchSDK::MetricsSnapshot before = GlitchSDK::GetMetrics();
+        Result result;
+
+        // Producer: queues a slice of the rate every 10 ms until the cooldown is over
+        Clock::time_point start = Clock::now();
+        Clock::time_point faultStart = start + warmup;
+        Clock::time_point faultEnd = faultStart + fault;
+        Clock::time_point produceUntil = faultEnd + std::chrono::seconds(options.CooldownSeconds);
+        transport->SetScript(script);
+        std::atomic<size_t> offered(0);
+        std::thread producer([&]() {
+            GlitchSDK::GameEventData event;
+            event.GameInstallID = "00000000-0000-0000-0000-000000000002";
+            event.ActionKey = "item_crafted";
+            Clock::time_point tick = start;
+            while (tick < produceUntil) {
+                size_t due = size_t(std::chrono::duration<double>(tick - start).count() * options.Rate);
+                for (size_t i = offered.load(); i < due; ++i) {
+                    event.StepKey = "level_" + std::to_string(i % 40);
+                    event.MetadataJSON = R"({"seq":)" + std::to_string(i) + "}";
+                    client->QueueEvent(event);
+                    offered.fetch_add(1);
+                }
+                tick += std::chrono::milliseconds(10);
+                std::this_thread::sleep_until(tick);
+            }
+        });
+
+        // Sampler: queue size and memory every 10 ms until everything is sent or we give up
+        size_t baseline = config.MaxBatchEvents;
+        size_t queueAtFaultStart = 0;
+        size_t queueAtFaultEnd = 0;
+        bool faultStarted = false, faultEnded = false;
+        uint64_t acceptedAtFaultStart = 0;
+        Clock::time_point giveUp = produceUntil + std::chrono::seconds(options.MaxWaitSeconds);
+        for (;;) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            Clock::time_point now = Clock::now();
+            size_t queued = client->GetQueuedCount();
+            GlitchSDK::MetricsSnapshot metrics = GlitchSDK::GetMetrics();
+            result.PeakQueue = std::max(result.PeakQueue, queued);
+            result.PeakQueueBytes = std::max(result.PeakQueueBytes, metrics.QueueBytes);
+
+            if (now < faultStart) {
+                baseline = std::max(baseline, queued);
+            } else if (!faultStarted) {
+                faultStarted = true;
+                queueAtFaultStart = queued;
+                acceptedAtFaultStart = metrics.EventsAccepted;
+            }
+            if (now >= faultEnd && !faultEnded) {
+                faultEnded = true;
+                queueAtFaultEnd = queued;
+                result.AcceptedDuringFault = metrics.EventsAccepted - acceptedAtFaultStart;
+            }
+            if (faultEnded && result.RecoveryMs < 0.0 && queued <= baseline) {
+                result.RecoveryMs = std::chrono::duration<double, std::milli>(now - faultEnd).count();
+            }
+            if ((now >= produceUntil && queued == 0) || now >= giveUp) break;
+        }
+        producer.join();
+
+        client->Flush();
+        GlitchSDK::ShutdownReport report = client->Shutdown(Clock::now() + std::chrono::seconds(2));
+        client.reset();
+
+        GlitchSDK::MetricsSnapshot after = GlitchSDK::GetMetrics();
+        result.Offered = offered.load();
+        result.Accepted = after.EventsAccepted - before.EventsAccepted;
+        result.Retried = after.EventsRetried - before.EventsRetried;
+        result.DeadLettered = after.EventsDeadLettered - before.EventsDeadLettered;
+        result.Dropped = after.EventsDropped - before.EventsDropped;
+        result.Lost = report.EventsSpilled + report.Lost;
+        result.GrowthPerSecond = (double(queueAtFaultEnd) - double(queueAtFaultStart)) / std::max(1, options.FaultSeconds);
+        result.Faults = transport->GetStats();
+
+        GlitchSDK::SetTimeoutPolicy(GlitchSDK::Endpoint::Events, savedPolicy);
+        GlitchSDK::SetTransport(nullptr);
+        return result;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    Options options;
+    const char* only = nullptr;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "--rate") == 0) options.Rate = std::max(1, std::atoi(argv[i + 1]));
+        else if (strcmp(argv[i], "--fault-seconds") == 0) options.FaultSeconds = std::max(1, std::atoi(argv[i + 1]));
+        else if (strcmp(argv[i], "--flush-ms") == 0) options.FlushIntervalMs = std::max(1, std::atoi(argv[i + 1]));
+        else if (strcmp(argv[i], "--attempts") == 0) options.MaxEventAttempts = std::max(1, std::atoi(argv[i + 1]));
+        else if (strcmp(argv[i], "--seed") == 0) options.Seed = std::strtoull(argv[i + 1], nullptr, 10);
+        else if (strcmp(argv[i], "--scenario") == 0) only = argv[i + 1];
+    }
+
+    std::printf("%d events/s, %d s fault, flush every %d ms, %d attempts\n", options.Rate, options.FaultSeconds,
+                options.FlushIntervalMs, options.MaxEventAttempts);
+    std::printf("%-11s %8s %10s %10s %10s %10s %9s %6s %7s %10s %6s %7s %6s\n", "scenario", "queued", "delivered", "fault ev/s",
+                "peak queue", "growth/s", "queue KB", "amp", "reqs", "recovery", "dead", "dropped", "lost");
+
+    int unaccounted = 0;
+    for (const Scenario& scenario : MakeScenarios()) {
+        if (only && strcmp(only, scenario.Name) != 0) continue;
+        Result result = Run(scenario, options);
+
+        uint64_t sends = result.Accepted + result.Retried + result.DeadLettered;
+        char recovery[32];
+        if (result.RecoveryMs >= 0.0) std::snprintf(recovery, sizeof(recovery), "%.0f ms", result.RecoveryMs);
+        else std::snprintf(recovery, sizeof(recovery), "never");
+        std::printf("%-11s %8zu %9.1f%% %10.0f %10zu %10.0f %9.1f %6.2f %7llu %10s %6llu %7llu %6zu\n", scenario.Name,
+                    result.Offered, result.Offered ? 100.0 * double(result.Accepted) / double(result.Offered) : 0.0,
+                    double(result.AcceptedDuringFault) / options.FaultSeconds, result.PeakQueue, result.GrowthPerSecond,
+                    double(result.PeakQueueBytes) / 1024.0, result.Accepted ? double(sends) / double(result.Accepted) : 0.0,
+                    (unsigned long long)result.Faults.Requests, recovery, (unsigned long long)result.DeadLettered,
+                    (unsigned long long)result.Dropped, result.Lost);
+
+        uint64_t settled = result.Accepted + result.DeadLettered + result.Dropped + result.Lost;
+        if (settled != result.Offered) {
+            unaccounted++;
+            std::printf("  %s: %zu queued but %llu accounted for\n", scenario.Name, result.Offered, (unsigned long long)settled);
+        }
+    }
+    return unaccounted == 0 ? 0 : 1;
+}